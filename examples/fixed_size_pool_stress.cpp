@@ -0,0 +1,243 @@
+/*
+ * @FilePath: /examples/fixed_size_pool_stress.cpp
+ * @Author: SweerItTer xxxzhou.xian@gmail.com
+ * @Date: 2026-03-06
+ * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
+ * @Description: 多个不同块大小的 FixedSizePool 在多线程下交替分配/跨线程释放的压力测试,
+ *               每个块按所属池写满校验图案, 拿到别的池(尺寸不对)的块会破坏相邻块的图案;
+ *               以及突发分配 -> trim 归还页面 -> trim 后复用, 自动 trim 水位线的检查
+ */
+
+#include "fixedSizePool.h"
+#include "spscQueue.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int kThreads = 8;
+constexpr int kOpsPerThread = 200000;
+constexpr size_t kBlockSizes[] = {40, 128, 448, 1024};
+constexpr int kPools = sizeof(kBlockSizes) / sizeof(kBlockSizes[0]);
+
+std::atomic<uint64_t> g_errors{0};
+
+// 块头记录所属池, 其余字节用池序号 + 块地址生成的图案填满
+struct Block {
+    void* ptr;
+    int pool;
+};
+
+inline uint8_t patternByte(const void* p, int pool, size_t i) {
+    return static_cast<uint8_t>((reinterpret_cast<uintptr_t>(p) >> 6) + pool * 31 + i);
+}
+
+void fill(void* p, int pool) {
+    uint8_t* bytes = static_cast<uint8_t*>(p);
+    for (size_t i = 0; i < kBlockSizes[pool]; ++i) bytes[i] = patternByte(p, pool, i);
+}
+
+void verify(const Block& block) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(block.ptr);
+    for (size_t i = 0; i < kBlockSizes[block.pool]; ++i) {
+        if (bytes[i] != patternByte(block.ptr, block.pool, i)) {
+            g_errors.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+// 每个线程随机选池分配, 持有一批后按随机顺序释放; 约四分之一的块交给下一个线程释放
+void worker(int index, std::vector<std::unique_ptr<FixedSizePool>>& pools,
+            std::vector<std::unique_ptr<SpscQueue<Block>>>& handoff) {
+    std::mt19937 rng(static_cast<uint32_t>(index * 7919 + 1));
+    std::vector<Block> held;
+    held.reserve(512);
+    // 线程 i 只向 i+1 交接, 每条交接边恰好一个生产者一个消费者
+    SpscQueue<Block>& next = *handoff[(index + 1) % kThreads];
+    SpscQueue<Block>& mine = *handoff[index];
+
+    for (int op = 0; op < kOpsPerThread; ++op) {
+        if (held.size() < 256 && (rng() & 1)) {
+            const int pool = static_cast<int>(rng() % kPools);
+            void* p = pools[pool]->allocate();
+            if (!p) {
+                g_errors.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            fill(p, pool);
+            held.push_back(Block{p, pool});
+        } else if (!held.empty()) {
+            const size_t pos = rng() % held.size();
+            const Block block = held[pos];
+            held[pos] = held.back();
+            held.pop_back();
+            verify(block);
+            if ((rng() & 3) != 0 || !next.try_push(block)) {
+                pools[block.pool]->deallocate(block.ptr);
+            }
+        }
+
+        Block foreign;
+        while (mine.try_pop(foreign)) {
+            verify(foreign);
+            pools[foreign.pool]->deallocate(foreign.ptr);
+        }
+    }
+    for (const Block& block : held) {
+        verify(block);
+        pools[block.pool]->deallocate(block.ptr);
+    }
+}
+
+// 线程反复创建/销毁临时池, 检查已销毁池的线程缓存表项被清理且不影响长期存活的池
+void churn(std::vector<std::unique_ptr<FixedSizePool>>& pools) {
+    for (int round = 0; round < 200; ++round) {
+        FixedSizePool temp(64 + (round % 8) * 16, 64);
+        std::vector<void*> blocks;
+        for (int i = 0; i < 100; ++i) blocks.push_back(temp.allocate());
+        for (void* p : blocks) temp.deallocate(p);
+
+        void* p = pools[round % kPools]->allocate();
+        fill(p, round % kPools);
+        verify(Block{p, round % kPools});
+        pools[round % kPools]->deallocate(p);
+    }
+}
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::printf("  check failed: %s (line %d)\n", #cond, __LINE__); \
+            g_errors.fetch_add(1, std::memory_order_relaxed);               \
+        }                                                                   \
+    } while (0)
+
+// 当前进程 RSS(KB)
+long rssKb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) return std::stol(line.substr(6));
+    }
+    return -1;
+}
+
+// 模拟分辨率切换: 突发分配大量块 -> 全部释放 -> trim 归还页面 -> 再次分配复用
+void trimCheck() {
+    constexpr size_t kBlock = 4096;
+    constexpr size_t kPerPage = 64;
+    constexpr size_t kBurst = 64 * 1024;   // 256MB
+    FixedSizePool pool(kBlock, kPerPage, 64);
+
+    const long rss0 = rssKb();
+    std::vector<void*> blocks;
+    blocks.reserve(kBurst);
+    for (size_t i = 0; i < kBurst; ++i) {
+        void* p = pool.allocate();
+        std::memset(p, 0x5a, kBlock);
+        blocks.push_back(p);
+    }
+    auto stats = pool.get_stats();
+    const long rssPeak = rssKb();
+    CHECK(stats.live_blocks == kBurst);
+    CHECK(stats.pages == (kBurst + kPerPage - 1) / kPerPage);
+
+    for (void* p : blocks) pool.deallocate(p);
+    blocks.clear();
+    stats = pool.get_stats();
+    CHECK(stats.live_blocks == 0);
+    CHECK(stats.central_free + stats.cached_blocks == stats.total_blocks);
+
+    const size_t released = pool.trim(1);
+    stats = pool.get_stats();
+    const long rssTrim = rssKb();
+    CHECK(released > 0);
+    CHECK(stats.pages == 1);
+    CHECK(stats.cached_blocks == 0);
+    CHECK(stats.central_free == kPerPage);
+    CHECK(stats.trimmed_pages == released);
+    std::printf("trim: rss %ld KB -> peak %ld KB -> after trim %ld KB, released %zu pages\n",
+                rss0, rssPeak, rssTrim, released);
+
+    // trim 后复用: 剩余页先被用完, 之后重新扩展
+    for (size_t i = 0; i < 4 * kPerPage; ++i) {
+        void* p = pool.allocate();
+        CHECK(p != nullptr);
+        std::memset(p, 0xa5, kBlock);
+        blocks.push_back(p);
+    }
+    stats = pool.get_stats();
+    CHECK(stats.live_blocks == 4 * kPerPage);
+    CHECK(stats.pages >= 4);
+    for (void* p : blocks) pool.deallocate(p);
+    blocks.clear();
+
+    // 自动 trim: 其他线程突发后全部释放, 回冲到中心链表时低于水位线自动归还
+    FixedSizePool::TrimPolicy policy;
+    policy.auto_trim = true;
+    policy.low_watermark = 0.1;
+    policy.keep_pages = 2;
+    policy.min_interval = std::chrono::milliseconds(0);
+    pool.set_trim_policy(policy);
+    std::thread burst([&pool] {
+        std::vector<void*> local;
+        for (size_t i = 0; i < kBurst / 4; ++i) local.push_back(pool.allocate());
+        for (void* p : local) pool.deallocate(p);
+    });
+    burst.join();
+    stats = pool.get_stats();
+    std::printf("auto trim: pages %zu, trimmed total %zu, live %zu, central free %zu\n",
+                stats.pages, stats.trimmed_pages, stats.live_blocks, stats.central_free);
+    CHECK(stats.live_blocks == 0);
+    CHECK(stats.pages <= policy.keep_pages + (TLS_CACHE_SIZE + kPerPage - 1) / kPerPage);
+}
+
+} // namespace
+
+int main() {
+    std::vector<std::unique_ptr<FixedSizePool>> pools;
+    for (size_t size : kBlockSizes) pools.emplace_back(new FixedSizePool(size, 256, 64));
+    std::vector<std::unique_ptr<SpscQueue<Block>>> handoff;
+    for (int i = 0; i < kThreads; ++i) handoff.emplace_back(new SpscQueue<Block>(1024));
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back(worker, i, std::ref(pools), std::ref(handoff));
+    }
+    threads.emplace_back(churn, std::ref(pools));
+    for (auto& t : threads) t.join();
+
+    // 线程退出后交接队列里可能还有块
+    Block block;
+    for (auto& queue : handoff) {
+        while (queue->try_pop(block)) {
+            verify(block);
+            pools[block.pool]->deallocate(block.ptr);
+        }
+    }
+
+    for (auto& pool : pools) {
+        const auto stats = pool->get_stats();
+        std::printf("pool %4zu B: pages %zu, live %zu, central free %zu, cached %zu in %zu threads\n",
+                    stats.block_size, stats.pages, stats.live_blocks, stats.central_free,
+                    stats.cached_blocks, stats.cached_per_thread.size());
+        CHECK(stats.live_blocks == 0);
+    }
+
+    trimCheck();
+
+    const uint64_t errors = g_errors.load();
+    std::printf("FixedSizePool stress: %d pools x %d threads, %d ops/thread: %s (%llu errors)\n",
+                kPools, kThreads, kOpsPerThread, errors == 0 ? "PASS" : "FAIL",
+                static_cast<unsigned long long>(errors));
+    return errors == 0 ? 0 : 1;
+}
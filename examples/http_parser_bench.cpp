@@ -0,0 +1,306 @@
+/*
+ * @FilePath: /examples/http_parser_bench.cpp
+ * @Author: SweerItTer xxxzhou.xian@gmail.com
+ * @Date: 2026-03-11
+ * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
+ * @Description: HttpRequestParser 边界检查 (pipelined / 任意位置拆分 / 大小写 / chunked / 非法输入)
+ *               以及在抓包请求样本上与旧 tryParseHttp (substr + istringstream) 的吞吐对比
+ */
+
+#include "net/httpParser.h"
+
+#include <chrono>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using utils::net::HttpRequest;
+using utils::net::HttpRequestParser;
+
+namespace {
+
+int g_errors = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::printf("  check failed: %s (line %d)\n", #cond, __LINE__); \
+            ++g_errors;                                                     \
+        }                                                                   \
+    } while (0)
+
+// 抓包得到的典型请求: curl, 浏览器, 轮询客户端, JSON API
+const char* const kCorpus[] = {
+    "GET /api/ping HTTP/1.1\r\n"
+    "Host: 192.168.1.20:18080\r\n"
+    "User-Agent: curl/7.81.0\r\n"
+    "Accept: */*\r\n"
+    "\r\n",
+
+    "GET /static/index.html HTTP/1.1\r\n"
+    "Host: 192.168.1.20:18080\r\n"
+    "Connection: keep-alive\r\n"
+    "Cache-Control: max-age=0\r\n"
+    "Upgrade-Insecure-Requests: 1\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/122.0.0.0 Safari/537.36\r\n"
+    "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;q=0.8\r\n"
+    "Accept-Encoding: gzip, deflate\r\n"
+    "Accept-Language: zh-CN,zh;q=0.9,en;q=0.8\r\n"
+    "If-None-Match: \"5f2a-1a3\"\r\n"
+    "If-Modified-Since: Tue, 05 Mar 2026 08:12:44 GMT\r\n"
+    "\r\n",
+
+    "GET /camera/0/status?fields=fps,temp HTTP/1.1\r\n"
+    "Host: edge-box.local\r\n"
+    "Accept: application/json\r\n"
+    "Connection: keep-alive\r\n"
+    "\r\n",
+
+    "POST /api/echo HTTP/1.1\r\n"
+    "Host: 127.0.0.1:18080\r\n"
+    "User-Agent: python-requests/2.31.0\r\n"
+    "Accept-Encoding: gzip, deflate\r\n"
+    "Accept: */*\r\n"
+    "Connection: keep-alive\r\n"
+    "Content-Type: application/json\r\n"
+    "Content-Length: 61\r\n"
+    "\r\n"
+    "{\"message\":\"Hello\",\"frame\":1024,\"roi\":[12,40,320,240],\"ok\":1}",
+};
+
+// ---- 旧实现 (src/utils/net/server.cpp 中的 tryParseHttp), 作为对比基线 ----
+std::string legacyToLower(std::string s) {
+    for (auto& ch : s) ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+    return s;
+}
+
+std::string legacyTrim(std::string s) {
+    auto isSpace = [](unsigned char c) { return std::isspace(c) != 0; };
+    while (!s.empty() && isSpace(static_cast<unsigned char>(s.front()))) s.erase(s.begin());
+    while (!s.empty() && isSpace(static_cast<unsigned char>(s.back()))) s.pop_back();
+    return s;
+}
+
+bool legacyParse(std::string& buf, HttpRequest& out) {
+    const auto headerEnd = buf.find("\r\n\r\n");
+    if (headerEnd == std::string::npos) return false;
+
+    const std::string headerBlock = buf.substr(0, headerEnd);
+    std::string remain = buf.substr(headerEnd + 4);
+
+    std::istringstream iss(headerBlock);
+    std::string requestLine;
+    if (!std::getline(iss, requestLine)) return false;
+    if (!requestLine.empty() && requestLine.back() == '\r') requestLine.pop_back();
+
+    std::istringstream rl(requestLine);
+    rl >> out.method >> out.target >> out.version;
+    if (out.method.empty() || out.target.empty() || out.version.empty()) return false;
+
+    out.headers.clear();
+    std::string line;
+    while (std::getline(iss, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        const auto colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        const std::string k = legacyToLower(legacyTrim(line.substr(0, colon)));
+        const std::string v = legacyTrim(line.substr(colon + 1));
+        if (!k.empty()) out.headers[k] = v;
+    }
+
+    size_t need = 0;
+    const auto it = out.headers.find("content-length");
+    if (it != out.headers.end()) need = static_cast<size_t>(std::strtoul(it->second.c_str(), nullptr, 10));
+    if (remain.size() < need) return false;
+
+    out.body = remain.substr(0, need);
+    buf = remain.substr(need);
+    return true;
+}
+
+// ---- 新解析器的驱动: 模拟连接缓冲区, 每次到达 chunk 字节 ----
+std::vector<HttpRequest> feed(const std::string& stream, size_t chunk, HttpRequestParser& parser, bool* failed) {
+    std::vector<HttpRequest> out;
+    std::string buf;
+    size_t offset = 0;
+    *failed = false;
+    for (size_t pos = 0; pos < stream.size(); pos += chunk) {
+        buf.append(stream, pos, chunk);
+        while (offset < buf.size()) {
+            HttpRequest req;
+            const auto st = parser.parse(buf.data() + offset, buf.size() - offset, req);
+            if (st == HttpRequestParser::Status::NEED_MORE) break;
+            if (st == HttpRequestParser::Status::ERROR) {
+                *failed = true;
+                return out;
+            }
+            offset += parser.consumed();
+            out.push_back(std::move(req));
+        }
+        buf.erase(0, offset);
+        offset = 0;
+    }
+    return out;
+}
+
+std::string header(const HttpRequest& req, const char* name) {
+    const auto it = req.headers.find(name);
+    return it == req.headers.end() ? std::string("<none>") : it->second;
+}
+
+void checkEdgeCases() {
+    std::string pipelined;
+    for (const char* r : kCorpus) pipelined += r;
+
+    // 任意拆分位置 (含逐字节到达) 的结果都应与一次性到达相同
+    for (size_t chunk = 1; chunk <= pipelined.size(); chunk += (chunk < 16 ? 1 : 37)) {
+        HttpRequestParser parser;
+        bool failed = false;
+        const auto reqs = feed(pipelined, chunk, parser, &failed);
+        CHECK(!failed);
+        CHECK(reqs.size() == 4);
+        if (reqs.size() != 4) continue;
+        CHECK(reqs[0].method == "GET" && reqs[0].target == "/api/ping" && reqs[0].version == "HTTP/1.1");
+        CHECK(header(reqs[1], "user-agent").find("Chrome/122") != std::string::npos);
+        CHECK(header(reqs[1], "if-none-match") == "\"5f2a-1a3\"");
+        CHECK(reqs[2].path() == "/camera/0/status");
+        CHECK(reqs[3].method == "POST" && reqs[3].body.size() == 61 && reqs[3].body.back() == '}');
+    }
+
+    HttpRequestParser parser;
+    bool failed = false;
+
+    // 头部名大小写不敏感, 保留原始写法; 值去掉两端空白
+    auto reqs = feed("GET / HTTP/1.1\r\nX-Trace-ID:   abc  \r\nCONTENT-length: 2\r\n\r\nhi", 64, parser, &failed);
+    CHECK(!failed && reqs.size() == 1);
+    if (!reqs.empty()) {
+        CHECK(header(reqs[0], "x-trace-id") == "abc");
+        CHECK(header(reqs[0], "X-TRACE-ID") == "abc");
+        CHECK(reqs[0].body == "hi");
+        CHECK(reqs[0].headers.begin()->first != "x-trace-id" || reqs[0].headers.size() == 2);
+    }
+
+    // 裸 LF 行尾与请求前的空行
+    reqs = feed("\r\n\nGET /lf HTTP/1.0\nHost: a\n\n", 3, parser, &failed);
+    CHECK(!failed && reqs.size() == 1 && reqs[0].target == "/lf" && header(reqs[0], "host") == "a");
+
+    // body 恰好在后续请求之前截断, 下一请求紧随其后
+    reqs = feed("POST /a HTTP/1.1\r\nContent-Length: 3\r\n\r\nabcGET /b HTTP/1.1\r\n\r\n", 5, parser, &failed);
+    CHECK(!failed && reqs.size() == 2 && reqs[0].body == "abc" && reqs[1].target == "/b");
+
+    // chunked 请求体: 任意拆分位置解码结果相同, chunk-ext 与 trailer 被跳过, 后续请求边界正确
+    const std::string chunkedStream =
+        "POST /up HTTP/1.1\r\nTransfer-Encoding: gzip, Chunked\r\n\r\n"
+        "4;ext=1\r\nWiki\r\n5\r\npedia\r\nE\r\n in\r\n\r\nchunks.\r\n0\r\nExpires: never\r\n\r\n"
+        "GET /next HTTP/1.1\r\n\r\n";
+    for (size_t chunk = 1; chunk <= chunkedStream.size(); ++chunk) {
+        HttpRequestParser chunkedParser;
+        reqs = feed(chunkedStream, chunk, chunkedParser, &failed);
+        CHECK(!failed && reqs.size() == 2);
+        if (reqs.size() != 2) continue;
+        CHECK(reqs[0].body == "Wikipedia in\r\n\r\nchunks.");
+        CHECK(reqs[1].target == "/next");
+    }
+
+    // 非法输入: 缺少字段的请求行, 非数字 Content-Length, 超长头部
+    HttpRequestParser bad1;
+    feed("GET /only-two\r\n\r\n", 64, bad1, &failed);
+    CHECK(failed);
+    HttpRequestParser bad2;
+    feed("POST / HTTP/1.1\r\nContent-Length: 12x\r\n\r\n", 64, bad2, &failed);
+    CHECK(failed);
+    HttpRequestParser::Limits limits;
+    limits.maxHeaderBytes = 256;
+    HttpRequestParser bad3(limits);
+    feed("GET / HTTP/1.1\r\nX-Big: " + std::string(300, 'a'), 16, bad3, &failed);
+    CHECK(failed);
+    CHECK(bad3.error() != nullptr);
+
+    // 非法 chunked: 同时带 Content-Length, 不支持的编码, 非十六进制长度, 数据后缺少 CRLF, 超过 body 上限
+    const char* const badChunked[] = {
+        "POST / HTTP/1.1\r\nContent-Length: 5\r\nTransfer-Encoding: chunked\r\n\r\n0\r\n\r\n",
+        "POST / HTTP/1.1\r\nTransfer-Encoding: gzip\r\n\r\n",
+        "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nzz\r\n",
+        "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nabcd\r\n",
+        "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nffffffffffffffffff\r\n",
+    };
+    for (const char* input : badChunked) {
+        HttpRequestParser badParser;
+        feed(input, 7, badParser, &failed);
+        CHECK(failed);
+    }
+    limits.maxHeaderBytes = 64 * 1024;
+    limits.maxBodyBytes = 8;
+    HttpRequestParser small(limits);
+    feed("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nabcde\r\n5\r\nfghij\r\n0\r\n\r\n", 64, small,
+         &failed);
+    CHECK(failed);
+}
+
+template <typename Fn>
+double requestsPerSec(size_t requests, Fn&& fn) {
+    const auto t0 = std::chrono::steady_clock::now();
+    fn();
+    const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return requests / sec;
+}
+
+void bench(size_t chunk, int rounds) {
+    std::string stream;
+    for (int i = 0; i < 64; ++i) stream += kCorpus[i % 4];
+    const size_t requests = 64 * static_cast<size_t>(rounds);
+    size_t sink = 0;
+
+    // 旧实现: 每次 recv 后从头调用 tryParseHttp
+    const double legacy = requestsPerSec(requests, [&] {
+        for (int r = 0; r < rounds; ++r) {
+            std::string buf;
+            for (size_t pos = 0; pos < stream.size(); pos += chunk) {
+                buf.append(stream, pos, chunk);
+                HttpRequest req;
+                while (legacyParse(buf, req)) sink += req.target.size();
+            }
+        }
+    });
+
+    HttpRequestParser parser;
+    const double fresh = requestsPerSec(requests, [&] {
+        for (int r = 0; r < rounds; ++r) {
+            std::string buf;
+            size_t offset = 0;
+            for (size_t pos = 0; pos < stream.size(); pos += chunk) {
+                buf.append(stream, pos, chunk);
+                HttpRequest req;
+                while (offset < buf.size() &&
+                       parser.parse(buf.data() + offset, buf.size() - offset, req) ==
+                           HttpRequestParser::Status::COMPLETE) {
+                    offset += parser.consumed();
+                    sink += req.target.size();
+                }
+                buf.erase(0, offset);
+                offset = 0;
+            }
+        }
+    });
+
+    std::printf("%-14zu %14.0f %14.0f %8.2fx\n", chunk, legacy, fresh, fresh / legacy);
+    if (sink == 0) std::printf("unreachable\n");
+}
+
+} // namespace
+
+int main() {
+    checkEdgeCases();
+    std::printf("edge cases: %s\n", g_errors == 0 ? "PASS" : "FAIL");
+
+    std::printf("\n=== corpus of %zu captured requests, 64 pipelined per stream (req/s) ===\n",
+                sizeof(kCorpus) / sizeof(kCorpus[0]));
+    std::printf("%-14s %14s %14s %9s\n", "recv chunk", "tryParseHttp", "HttpParser", "speedup");
+    bench(1 << 16, 2000); // 一次到齐
+    bench(1460, 2000);    // 按 MSS 到达
+    bench(64, 500);       // 小片段到达 (慢客户端)
+    return g_errors == 0 ? 0 : 1;
+}
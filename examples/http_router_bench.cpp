@@ -0,0 +1,299 @@
+/*
+ * @FilePath: /examples/http_router_bench.cpp
+ * @Author: SweerItTer xxxzhou.xian@gmail.com
+ * @Date: 2026-03-16
+ * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
+ * @Description: HttpRouter 路由检查 (参数捕获 / 静态段优先与回溯 / 通配 / 前缀挂载 / 405 / 非法模式)
+ *               以及几百条路由下的查找耗时: HttpRouter::dispatch 各类命中, RouteTree 与逐条模式比对
+ *               用法: Http_Router_Bench [lookups=1000000]
+ */
+
+#include "net/routeTree.h"
+#include "net/server.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace utils::net;
+
+namespace {
+
+int g_errors = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::printf("  check failed: %s (line %d)\n", #cond, __LINE__); \
+            ++g_errors;                                                     \
+        }                                                                   \
+    } while (0)
+
+constexpr int kResources = 100; // 每个资源 2 条精确路由 + 2 条模式路由
+
+// 最近一次被调用的 handler 及其看到的参数
+int g_hit = -1;
+HttpParams g_params;
+
+HttpHandler tag(int id) {
+    return [id](const ConnectionContext&, const HttpRequest& req) {
+        g_hit = id;
+        g_params = req.params;
+        return Response{};
+    };
+}
+
+HttpRequest makeRequest(const std::string& method, const std::string& target) {
+    HttpRequest req;
+    req.method = method;
+    req.target = target;
+    req.version = "HTTP/1.1";
+    req.headers["Host"] = "127.0.0.1";
+    return req;
+}
+
+// 返回命中的 handler 编号; 未命中任何 handler 时为 -(状态码)
+int route(const HttpRouter& router, const std::string& method, const std::string& target) {
+    g_hit = -1;
+    g_params.clear();
+    HttpRequest req = makeRequest(method, target);
+    const Response resp = router.dispatch(ConnectionContext{}, req);
+    if (g_hit >= 0) return g_hit;
+    return -std::atoi(resp.head.c_str() + 9); // "HTTP/1.1 404 ..."
+}
+
+std::string param(const std::string& name) {
+    for (const auto& entry : g_params) {
+        if (entry.first == name) return entry.second;
+    }
+    return "<none>";
+}
+
+void checkRouting() {
+    HttpRouter router;
+    CHECK(router.get("/users", tag(1)));
+    CHECK(router.get("/users/new", tag(2)));
+    CHECK(router.get("/users/:id", tag(3)));
+    CHECK(router.get("/users/:id/posts/:post", tag(4)));
+    CHECK(router.post("/users/:id", tag(5)));
+    CHECK(router.get("/users/:id/files/*path", tag(6)));
+    CHECK(router.get("/a:b", tag(7)));            // 段中间的 ':' 是普通字符
+    CHECK(router.get("/team/:id/members", tag(8)));
+    CHECK(router.get("/team/lead/profile", tag(9)));
+    CHECK(router.get("/assets/*", tag(10)));
+    CHECK(router.mount("/legacy/", tag(11)));
+    CHECK(router.get("/legacy/special", tag(12)));
+
+    // 重复与冲突
+    CHECK(!router.get("/users/new", tag(99)));
+    CHECK(!router.get("/users/:id", tag(99)));
+    CHECK(!router.get("/users/:name/likes", tag(99)));
+    CHECK(!router.get("/x/*rest/more", tag(99)));
+    CHECK(!router.get("/x/:", tag(99)));
+    CHECK(!router.mount("/legacy", tag(99)));
+    CHECK(!router.mount("legacy", tag(99)));
+
+    CHECK(route(router, "GET", "/users") == 1);
+    CHECK(route(router, "GET", "/users/new") == 2);
+    CHECK(route(router, "GET", "/users/42") == 3 && param("id") == "42");
+    CHECK(route(router, "GET", "/users/42?verbose=1") == 3 && param("id") == "42");
+    CHECK(route(router, "GET", "/users/42/posts/7") == 4 && param("id") == "42" && param("post") == "7");
+    // 静态段 "new" 之后走不通, 回溯到 :id
+    CHECK(route(router, "GET", "/users/new/posts/7") == 4 && param("id") == "new" && g_params.size() == 2);
+    CHECK(route(router, "POST", "/users/42") == 5 && param("id") == "42");
+    CHECK(route(router, "GET", "/users/42/files/a/b.txt") == 6 && param("path") == "a/b.txt");
+    CHECK(route(router, "GET", "/users/42/files/") == 6 && param("path").empty());
+    CHECK(route(router, "GET", "/a:b") == 7);
+    CHECK(route(router, "GET", "/team/lead/members") == 8 && param("id") == "lead");
+    CHECK(route(router, "GET", "/team/lead/profile") == 9 && g_params.empty());
+    CHECK(route(router, "GET", "/assets/css/site.css") == 10 && param("*") == "css/site.css");
+
+    // 挂载: 任意方法, 按方法注册的路由优先
+    CHECK(route(router, "GET", "/legacy") == 11 && g_params.empty());
+    CHECK(route(router, "DELETE", "/legacy/x/y") == 11 && param("*") == "x/y");
+    CHECK(route(router, "GET", "/legacy/special") == 12);
+    CHECK(route(router, "POST", "/legacy/special") == 11 && param("*") == "special");
+    CHECK(route(router, "GET", "/legacyx") == -404);
+
+    // 未命中: 空参数段, 多余的段, 其他方法
+    CHECK(route(router, "GET", "/users/") == -404);
+    CHECK(route(router, "GET", "/users/42/posts") == -404);
+    CHECK(route(router, "DELETE", "/users/42") == -405);
+    CHECK(route(router, "PUT", "/users/new") == -405);
+    CHECK(route(router, "GET", "/nothing") == -404);
+
+    // const 重载复制请求后写入参数, 原请求不变
+    const HttpRequest constReq = makeRequest("GET", "/users/9");
+    g_hit = -1;
+    router.dispatch(ConnectionContext{}, constReq);
+    CHECK(g_hit == 3 && param("id") == "9" && constReq.params.empty());
+
+    // 根挂载兜底一切
+    HttpRouter root;
+    CHECK(root.get("/ping", tag(1)));
+    CHECK(root.mount("/", tag(2)));
+    CHECK(route(root, "GET", "/ping") == 1);
+    CHECK(route(root, "GET", "/") == 2 && param("*").empty());
+    CHECK(route(root, "PUT", "/any/thing") == 2 && param("*") == "any/thing");
+}
+
+// 对照: 逐条把路径与模式按段比较, 第一条命中即返回
+struct LinearPatterns {
+    std::vector<std::vector<std::string>> patterns;
+
+    static std::vector<std::string> split(const std::string& path) {
+        std::vector<std::string> segments;
+        size_t pos = 1;
+        while (pos <= path.size()) {
+            size_t end = path.find('/', pos);
+            if (end == std::string::npos) end = path.size();
+            segments.push_back(path.substr(pos, end - pos));
+            pos = end + 1;
+        }
+        return segments;
+    }
+
+    void add(const std::string& pattern) { patterns.push_back(split(pattern)); }
+
+    int match(const std::string& path, HttpParams& params) const {
+        const std::vector<std::string> segments = split(path);
+        for (size_t i = 0; i < patterns.size(); ++i) {
+            const auto& p = patterns[i];
+            if (p.size() != segments.size()) continue;
+            size_t k = 0;
+            for (; k < p.size(); ++k) {
+                if (p[k][0] == ':') continue;
+                if (p[k] != segments[k]) break;
+            }
+            if (k != p.size()) continue;
+            for (k = 0; k < p.size(); ++k) {
+                if (p[k][0] == ':') params.emplace_back(p[k].substr(1), segments[k]);
+            }
+            return static_cast<int>(i);
+        }
+        return -1;
+    }
+};
+
+std::string resource(int i) {
+    static const char* const kKinds[] = {"camera", "encoder", "sensor", "stream", "storage"};
+    return "/api/v1/" + std::string(kKinds[i % 5]) + std::to_string(i);
+}
+
+template <typename Fn>
+double nsPerOp(int n, Fn&& fn) {
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) fn(i);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / n;
+}
+
+void benchDispatch(int lookups) {
+    HttpRouter router;
+    int routes = 0;
+    for (int i = 0; i < kResources; ++i) {
+        routes += router.get(resource(i) + "/status", tag(i));
+        routes += router.post(resource(i) + "/config", tag(i));
+        routes += router.get(resource(i) + "/frames/:frame", tag(i));
+        routes += router.get(resource(i) + "/frames/:frame/meta/:key", tag(i));
+    }
+    routes += router.get("/files/*path", tag(0));
+    routes += router.mount("/legacy", tag(0));
+
+    struct Scenario {
+        const char* name;
+        const char* method;
+        std::string suffix;
+    };
+    const Scenario scenarios[] = {
+        {"exact GET", "GET", "/status"},
+        {"exact POST", "POST", "/config"},
+        {"pattern, 1 param", "GET", "/frames/1024"},
+        {"pattern, 2 params", "GET", "/frames/1024/meta/exposure"},
+        {"405 (wrong method)", "DELETE", "/status"},
+        {"404", "GET", "/missing"},
+    };
+
+    std::printf("=== HttpRouter::dispatch, %d routes, %d lookups per row ===\n", routes, lookups);
+    std::printf("%-22s %12s\n", "request", "ns/lookup");
+    for (const auto& s : scenarios) {
+        std::vector<HttpRequest> reqs;
+        for (int i = 0; i < kResources; ++i) reqs.push_back(makeRequest(s.method, resource(i) + s.suffix));
+        const double ns = nsPerOp(lookups, [&](int i) {
+            HttpRequest& req = reqs[i % kResources];
+            req.params.clear();
+            router.dispatch(ConnectionContext{}, req);
+        });
+        std::printf("%-22s %12.1f\n", s.name, ns);
+    }
+    std::vector<HttpRequest> tails;
+    tails.push_back(makeRequest("GET", "/files/www/img/logo.png"));
+    tails.push_back(makeRequest("PUT", "/legacy/cgi-bin/set.cgi"));
+    const char* const tailNames[] = {"wildcard", "mount"};
+    for (size_t t = 0; t < tails.size(); ++t) {
+        const double ns = nsPerOp(lookups, [&](int) {
+            tails[t].params.clear();
+            router.dispatch(ConnectionContext{}, tails[t]);
+        });
+        std::printf("%-22s %12.1f\n", tailNames[t], ns);
+    }
+}
+
+void benchMatchers(int lookups) {
+    RouteTree tree;
+    LinearPatterns linear;
+    int routes = 0;
+    for (int i = 0; i < kResources; ++i) {
+        for (const char* suffix : {"/frames/:frame", "/frames/:frame/meta/:key", "/tracks/:track", "/tracks/:track/cue"}) {
+            const std::string pattern = resource(i) + suffix;
+            tree.insert(pattern, static_cast<size_t>(routes));
+            linear.add(pattern);
+            ++routes;
+        }
+    }
+
+    std::vector<std::string> paths;
+    for (int i = 0; i < kResources; ++i) paths.push_back(resource(i) + "/tracks/7/cue");
+    for (const auto& path : paths) {
+        size_t id = 0;
+        HttpParams a;
+        HttpParams b;
+        CHECK(tree.match(path, id, a) && static_cast<int>(id) == linear.match(path, b) && a == b);
+    }
+
+    std::printf("\n=== pattern matching only, %d patterns, path like %s ===\n", routes, paths.back().c_str());
+    std::printf("%-22s %12s\n", "matcher", "ns/lookup");
+    HttpParams params;
+    size_t sink = 0;
+    const double treeNs = nsPerOp(lookups, [&](int i) {
+        size_t id = 0;
+        params.clear();
+        tree.match(paths[i % kResources], id, params);
+        sink += id;
+    });
+    const double linearNs = nsPerOp(lookups / 20, [&](int i) {
+        params.clear();
+        sink += static_cast<size_t>(linear.match(paths[i % kResources], params));
+    });
+    std::printf("%-22s %12.1f\n", "RouteTree", treeNs);
+    std::printf("%-22s %12.1f\n", "linear per-pattern", linearNs);
+    if (sink == 1) std::printf("\n"); // 防止循环被优化掉
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int lookups = (argc >= 2) ? std::atoi(argv[1]) : 1000000;
+
+    checkRouting();
+    benchDispatch(lookups);
+    benchMatchers(lookups);
+
+    if (g_errors) {
+        std::printf("\n%d check(s) failed\n", g_errors);
+        return 1;
+    }
+    std::printf("\nall routing checks passed\n");
+    return 0;
+}
@@ -77,6 +77,16 @@ public:
             return false;
         }
 
+        if (!registrar.registerHandler("hello",
+                [](const utils::net::ConnectionContext&, const utils::net::HttpRequest& request) {
+                    // 路由 "/api/hello/:name" 捕获的路径参数
+                    utils::net::JsonValue body = utils::net::JsonValue::object();
+                    body["hello"] = request.param("name");
+                    return utils::net::HttpResponse::ok().json(body).toResponse();
+                }, &error)) {
+            return false;
+        }
+
         if (!registrar.registerHandler("download",
                 [downloadFile](const utils::net::ConnectionContext&, const utils::net::HttpRequest&) {
                     struct stat fileStat {};
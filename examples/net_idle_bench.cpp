@@ -0,0 +1,241 @@
+/*
+ * @FilePath: /examples/net_idle_bench.cpp
+ * @Author: SweerItTer xxxzhou.xian@gmail.com
+ * @Date: 2026-03-16
+ * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
+ * @Description: 大量空闲连接下 reactor 循环的开销 (一问一答吞吐 / 每请求 CPU / 空载 CPU),
+ *               以及慢速发送请求头 (slowloris) 与请求体的连接按时限被关闭
+ *               用法: Net_Idle_Bench [idleConnections=10000] [requests=20000]
+ *               空闲连接由子进程持有, 避免与服务端共用 fd 上限
+ */
+
+#include "logger_config.h"
+#include "logger_v2.h"
+#include "net/server.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace utils::net;
+
+namespace {
+
+constexpr uint16_t kPort = 18280;
+constexpr int kHeaderTimeoutSec = 1;
+constexpr int kBodyTimeoutSec = 2;
+
+int connectTo(uint16_t port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (int attempt = 0; attempt < 50; ++attempt) {
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            return fd;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ::close(fd);
+    return -1;
+}
+
+bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        const ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// 子进程: 收到 'g' 后建立 count 个空闲连接, 回写 'r', 父进程关闭管道后退出
+void holdConnections(int cmdFd, int ackFd, int count) {
+    char cmd = 0;
+    if (::read(cmdFd, &cmd, 1) != 1) ::_exit(0);
+    std::vector<int> fds;
+    fds.reserve(static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i) {
+        const int fd = connectTo(kPort);
+        if (fd < 0) break;
+        fds.push_back(fd);
+    }
+    const char ack = fds.size() == static_cast<size_t>(count) ? 'r' : 'f';
+    if (::write(ackFd, &ack, 1) != 1) ::_exit(1);
+    while (::read(cmdFd, &cmd, 1) > 0) {}
+    ::_exit(0);
+}
+
+double cpuSeconds() {
+    rusage usage{};
+    ::getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+// 单连接一问一答, 进程 CPU 含客户端, 两种场景下客户端开销相同
+void pingPong(const char* name, int requests) {
+    const int fd = connectTo(kPort);
+    if (fd < 0) return;
+    const std::string req = "GET /ping HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+    char buf[4096];
+
+    const double cpu0 = cpuSeconds();
+    const auto t0 = std::chrono::steady_clock::now();
+    int done = 0;
+    for (; done < requests; ++done) {
+        if (!sendAll(fd, req)) break;
+        std::string resp;
+        while (resp.size() < 4 || resp.compare(resp.size() - 4, 4, "pong") != 0) {
+            const ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+            if (n <= 0) break;
+            resp.append(buf, static_cast<size_t>(n));
+        }
+    }
+    const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    const double cpu = cpuSeconds() - cpu0;
+    ::close(fd);
+    std::printf("%-28s %10.0f %16.1f\n", name, done / sec, cpu * 1e6 / (done ? done : 1));
+}
+
+// 对端没有任何流量时的 CPU 占用
+void idleCpu(const char* name) {
+    const double cpu0 = cpuSeconds();
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+    std::printf("%-28s %10.2f ms CPU per second\n", name, (cpuSeconds() - cpu0) * 1e3 / 2);
+}
+
+/*
+ * 慢速发送: count 个连接每 100ms 只发 1 字节; 一半停在请求头, 一半头部完整但请求体只发一部分.
+ * 打印两类连接被服务端关闭所用的最长时间; 超过 limitSec 仍有连接未关闭返回 false.
+ */
+bool slowClients(int count, double limitSec) {
+    const std::string header = "GET /ping HTTP/1.1\r\nHost: 127.0.0.1\r\nX-Padding: ";
+    const std::string bodyHead = "POST /ping HTTP/1.1\r\nHost: 127.0.0.1\r\nContent-Length: 4096\r\n\r\n";
+    std::vector<int> fds;
+    std::vector<bool> headerPhase;
+    for (int i = 0; i < count; ++i) {
+        const int fd = connectTo(kPort);
+        if (fd < 0) return false;
+        const bool inHeader = (i % 2 == 0);
+        sendAll(fd, inHeader ? header : bodyHead);
+        fds.push_back(fd);
+        headerPhase.push_back(inHeader);
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    double closedHeader = 0;
+    double closedBody = 0;
+    int open = count;
+    while (open > 0) {
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (elapsed > limitSec) break;
+        for (size_t i = 0; i < fds.size(); ++i) {
+            if (fds[i] < 0) continue;
+            char tmp[256];
+            const ssize_t r = ::recv(fds[i], tmp, sizeof(tmp), MSG_DONTWAIT);
+            const bool closed = (r == 0) || (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK) ||
+                                ::send(fds[i], "a", 1, MSG_NOSIGNAL) < 0;
+            if (!closed) continue;
+            (headerPhase[i] ? closedHeader : closedBody) = elapsed;
+            ::close(fds[i]);
+            fds[i] = -1;
+            --open;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    for (int fd : fds) {
+        if (fd >= 0) ::close(fd);
+    }
+    std::printf("%d slow clients, header timeout %ds / body timeout %ds: last closed after %.1fs / %.1fs, %d still open\n",
+                count, kHeaderTimeoutSec, kBodyTimeoutSec, closedHeader, closedBody, open);
+    return open == 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int idle = (argc >= 2) ? std::atoi(argv[1]) : 10000;
+    const int requests = (argc >= 3) ? std::atoi(argv[2]) : 20000;
+
+    // 在启动任何线程前 fork 出持有空闲连接的子进程
+    int cmdPipe[2];
+    int ackPipe[2];
+    if (::pipe(cmdPipe) != 0 || ::pipe(ackPipe) != 0) return 1;
+    const pid_t holder = ::fork();
+    if (holder < 0) return 1;
+    if (holder == 0) {
+        ::close(cmdPipe[1]);
+        ::close(ackPipe[0]);
+        holdConnections(cmdPipe[0], ackPipe[1], idle);
+    }
+    ::close(cmdPipe[0]);
+    ::close(ackPipe[1]);
+
+    utils::LoggerConfig loggerConfig = utils::LoggerConfig::defaultConfig();
+    loggerConfig.async = false;
+    loggerConfig.global_level = utils::LogLevel::WARN;
+    utils::LoggerV2::init(loggerConfig);
+
+    ServerConfig cfg;
+    cfg.bindAddress = "127.0.0.1";
+    cfg.port = kPort;
+    cfg.maxClients = 4096; // listen backlog
+    cfg.idleTimeoutSec = 120;
+    cfg.requestHeaderTimeoutSec = kHeaderTimeoutSec;
+    cfg.requestBodyTimeoutSec = kBodyTimeoutSec;
+    cfg.enableTcpKeepAlive = false;
+    Server server(cfg);
+    server.http().get("/ping", [](const ConnectionContext&, const HttpRequest&) {
+        return HttpResponse::ok().contentType("text/plain").body("pong").toResponse();
+    });
+    if (!server.start()) {
+        std::printf("start failed on port %u\n", kPort);
+        return 1;
+    }
+
+    std::printf("=== reactor loop cost, %d one-by-one requests ===\n", requests);
+    std::printf("%-28s %10s %16s\n", "scenario", "req/s", "CPU us/request");
+    pingPong("no idle connections", requests);
+
+    const auto accepted0 = server.getStats().connectionsAccepted;
+    char ack = 0;
+    if (::write(cmdPipe[1], "g", 1) != 1 || ::read(ackPipe[0], &ack, 1) != 1 || ack != 'r') {
+        std::printf("failed to open %d idle connections\n", idle);
+        return 1;
+    }
+    while (server.getStats().connectionsAccepted - accepted0 < static_cast<uint64_t>(idle)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    const std::string label = std::to_string(idle) + " idle connections";
+    pingPong(label.c_str(), requests);
+    idleCpu(label.c_str());
+
+    std::printf("\n=== slow senders ===\n");
+    const uint64_t timedOut0 = server.getStats().timedOutConnections;
+    const bool ok = slowClients(40, kBodyTimeoutSec + 2.0);
+    std::printf("connections closed by timeout: %llu\n",
+                static_cast<unsigned long long>(server.getStats().timedOutConnections - timedOut0));
+
+    ::close(cmdPipe[1]);
+    ::waitpid(holder, nullptr, 0);
+    server.stop();
+    server.join();
+    return ok ? 0 : 1;
+}
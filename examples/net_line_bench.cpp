@@ -0,0 +1,122 @@
+/*
+ * @FilePath: /examples/net_line_bench.cpp
+ * @Author: SweerItTer xxxzhou.xian@gmail.com
+ * @Date: 2026-03-12
+ * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
+ * @Description: 回环压测行协议: 单连接连续写入 N 行 "PING i", 统计全部 "PONG i" 返回的吞吐
+ *               用法: Net_Line_Bench [lines=100000]
+ */
+
+#include "logger_config.h"
+#include "logger_v2.h"
+#include "net/server.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint16_t kPort = 18230;
+
+int connectTo(uint16_t port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (int attempt = 0; attempt < 50; ++attempt) {
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) return fd;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ::close(fd);
+    return -1;
+}
+
+// 写入 lines 行, 每 burstBytes 一次 send; 另一线程读取并数换行, 返回 lines/s (失败返回 0)
+double streamLines(int lines, size_t burstBytes) {
+    const int fd = connectTo(kPort);
+    if (fd < 0) return 0;
+
+    std::atomic<int> received{0};
+    std::thread reader([&] {
+        char buf[65536];
+        int seen = 0;
+        while (seen < lines) {
+            const ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+            if (n <= 0) break;
+            for (ssize_t i = 0; i < n; ++i) seen += (buf[i] == '\n');
+        }
+        received.store(seen);
+    });
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::string burst;
+    for (int i = 0; i < lines; ++i) {
+        burst += "PING ";
+        burst += std::to_string(i);
+        burst += '\n';
+        if (burst.size() >= burstBytes || i + 1 == lines) {
+            size_t sent = 0;
+            while (sent < burst.size()) {
+                const ssize_t n = ::send(fd, burst.data() + sent, burst.size() - sent, MSG_NOSIGNAL);
+                if (n <= 0) break;
+                sent += static_cast<size_t>(n);
+            }
+            burst.clear();
+        }
+    }
+    reader.join();
+    const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    ::close(fd);
+    return received.load() == lines ? lines / sec : 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int lines = (argc >= 2) ? std::atoi(argv[1]) : 100000;
+
+    utils::LoggerConfig loggerConfig = utils::LoggerConfig::defaultConfig();
+    loggerConfig.async = false;
+    loggerConfig.global_level = utils::LogLevel::WARN;
+    utils::LoggerV2::init(loggerConfig);
+
+    utils::net::ServerConfig cfg;
+    cfg.bindAddress = "127.0.0.1";
+    cfg.port = kPort;
+    cfg.workerThreadsMin = 2;
+    cfg.workerThreadsMax = 4;
+    cfg.workerQueueSize = 128;
+    utils::net::Server server(cfg);
+    server.line().on("PING", [](const utils::net::ConnectionContext&, const utils::net::LineRequest& req) {
+        return utils::net::Response::bytes("PONG " + req.params + "\n");
+    });
+    if (!server.start()) {
+        std::printf("start failed on port %u\n", kPort);
+        return 1;
+    }
+
+    std::printf("=== %d lines over loopback, one connection ===\n", lines);
+    std::printf("%-12s %14s\n", "send burst", "lines/s");
+    int failures = 0;
+    const size_t bursts[] = {64, 4096, 1 << 20};
+    for (size_t burst : bursts) {
+        const double rate = streamLines(lines, burst);
+        std::printf("%-12zu %14.0f\n", burst, rate);
+        if (rate == 0) ++failures;
+    }
+
+    server.stop();
+    server.join();
+    return failures == 0 ? 0 : 1;
+}
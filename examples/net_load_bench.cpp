@@ -0,0 +1,187 @@
+/*
+ * @FilePath: /examples/net_load_bench.cpp
+ * @Author: SweerItTer xxxzhou.xian@gmail.com
+ * @Date: 2026-03-10
+ * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
+ * @Description: 回环压测: 多个 keep-alive 连接闭环请求 GET /ping, 统计不同 ioThreads 下的 req/s 与 p50/p99 延迟
+ *               用法: Net_Load_Bench [seconds=2] [connections=32]
+ */
+
+#include "logger_config.h"
+#include "logger_v2.h"
+#include "net/server.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint16_t kBasePort = 18190;
+
+int connectTo(uint16_t port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (int attempt = 0; attempt < 50; ++attempt) {
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            return fd;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ::close(fd);
+    return -1;
+}
+
+// 读完一个响应 (head + Content-Length 字节), buf 中保留多读的部分
+bool readResponse(int fd, std::string& buf) {
+    char tmp[4096];
+    while (true) {
+        const auto headerEnd = buf.find("\r\n\r\n");
+        if (headerEnd != std::string::npos) {
+            size_t length = 0;
+            const auto cl = buf.find("Content-Length: ");
+            if (cl != std::string::npos && cl < headerEnd) length = std::strtoul(buf.c_str() + cl + 16, nullptr, 10);
+            const size_t total = headerEnd + 4 + length;
+            if (buf.size() >= total) {
+                buf.erase(0, total);
+                return true;
+            }
+        }
+        const ssize_t n = ::recv(fd, tmp, sizeof(tmp), 0);
+        if (n <= 0) return false;
+        buf.append(tmp, static_cast<size_t>(n));
+    }
+}
+
+struct Result {
+    double rps{0};
+    double p50Us{0};
+    double p99Us{0};
+    uint64_t errors{0};
+};
+
+Result runLoad(uint16_t port, int connections, double seconds) {
+    static const char kRequest[] = "GET /ping HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+
+    std::vector<std::vector<uint32_t>> latencies(connections);
+    std::atomic<uint64_t> errors{0};
+    std::atomic<bool> stop{false};
+
+    std::vector<std::thread> clients;
+    for (int c = 0; c < connections; ++c) {
+        clients.emplace_back([&, c] {
+            const int fd = connectTo(port);
+            if (fd < 0) {
+                errors.fetch_add(1);
+                return;
+            }
+            std::string buf;
+            auto& lat = latencies[c];
+            lat.reserve(1 << 16);
+            while (!stop.load(std::memory_order_relaxed)) {
+                const auto t0 = Clock::now();
+                if (::send(fd, kRequest, sizeof(kRequest) - 1, MSG_NOSIGNAL) != sizeof(kRequest) - 1 ||
+                    !readResponse(fd, buf)) {
+                    errors.fetch_add(1);
+                    break;
+                }
+                lat.push_back(static_cast<uint32_t>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - t0).count()));
+            }
+            ::close(fd);
+        });
+    }
+
+    const auto start = Clock::now();
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop.store(true);
+    for (auto& t : clients) t.join();
+    const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<uint32_t> all;
+    for (auto& v : latencies) all.insert(all.end(), v.begin(), v.end());
+    Result r;
+    r.errors = errors.load();
+    if (all.empty()) return r;
+    std::sort(all.begin(), all.end());
+    r.rps = all.size() / elapsed;
+    r.p50Us = all[all.size() / 2];
+    r.p99Us = all[std::min(all.size() - 1, all.size() * 99 / 100)];
+    return r;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const double seconds = (argc >= 2) ? std::atof(argv[1]) : 2.0;
+    const int connections = (argc >= 3) ? std::atoi(argv[2]) : 32;
+
+    utils::LoggerConfig loggerConfig = utils::LoggerConfig::defaultConfig();
+    loggerConfig.async = false;
+    loggerConfig.global_level = utils::LogLevel::WARN;
+    utils::LoggerV2::init(loggerConfig);
+
+    std::printf("=== GET /ping, %d keep-alive connections, %.1fs per run, %u cpus ===\n", connections, seconds,
+                std::thread::hardware_concurrency());
+    std::printf("%-4s %-10s %12s %10s %10s %8s\n", "io", "accept", "req/s", "p50 us", "p99 us", "errors");
+
+    struct Run {
+        uint32_t ioThreads;
+        bool reusePort;
+    };
+    const Run runs[] = {{1, true}, {2, true}, {2, false}, {4, true}, {4, false}};
+
+    int failures = 0;
+    uint16_t port = kBasePort;
+    for (const Run& run : runs) {
+        utils::net::ServerConfig cfg;
+        cfg.bindAddress = "127.0.0.1";
+        cfg.port = port++;
+        cfg.maxClients = 256;
+        cfg.ioThreads = run.ioThreads;
+        cfg.reusePort = run.reusePort;
+        cfg.workerThreadsMin = 4;
+        cfg.workerThreadsMax = 4;
+        cfg.workerQueueSize = 1024;
+
+        utils::net::Server server(cfg);
+        server.http().get("/ping", [](const utils::net::ConnectionContext&, const utils::net::HttpRequest&) {
+            return utils::net::HttpResponse::ok().contentType("text/plain").body("pong").toResponse();
+        });
+        if (!server.start()) {
+            std::printf("%-4u start failed on port %u\n", run.ioThreads, cfg.port);
+            ++failures;
+            continue;
+        }
+
+        const Result r = runLoad(cfg.port, connections, seconds);
+        server.stop();
+        server.join();
+
+        const char* mode = run.ioThreads == 1 ? "single" : (run.reusePort ? "reuseport" : "round-robin");
+        std::printf("%-4u %-10s %12.0f %10.0f %10.0f %8llu\n", run.ioThreads, mode, r.rps, r.p50Us, r.p99Us,
+                    static_cast<unsigned long long>(r.errors));
+        if (r.errors != 0 || r.rps == 0) ++failures;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,297 @@
+/*
+ * @FilePath: /examples/net_pipeline_check.cpp
+ * @Author: SweerItTer xxxzhou.xian@gmail.com
+ * @Date: 2026-03-13
+ * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
+ * @Description: 回环检查 HTTP pipelining: handler 乱序完成时响应仍按请求顺序返回,
+ *               在途请求上限生效, handler 抛异常不卡住连接, 以及对照 一问一答 的往返耗时
+ */
+
+#include "logger_config.h"
+#include "logger_v2.h"
+#include "net/server.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+using namespace utils::net;
+
+namespace {
+
+constexpr uint16_t kPort = 18240;
+constexpr uint32_t kMaxInFlight = 4;
+
+int g_errors = 0;
+std::atomic<int> g_active{0};
+std::atomic<int> g_peakActive{0};
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::printf("  check failed: %s (line %d)\n", #cond, __LINE__); \
+            ++g_errors;                                                     \
+        }                                                                   \
+    } while (0)
+
+int connectTo(uint16_t port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (int attempt = 0; attempt < 50; ++attempt) {
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            return fd;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ::close(fd);
+    return -1;
+}
+
+bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        const ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// 读取 count 个响应, 返回各自的 body
+std::vector<std::string> readBodies(int fd, size_t count) {
+    std::vector<std::string> bodies;
+    std::string buf;
+    char tmp[4096];
+    while (bodies.size() < count) {
+        const auto headerEnd = buf.find("\r\n\r\n");
+        if (headerEnd != std::string::npos) {
+            const auto cl = buf.find("Content-Length: ");
+            const size_t length = (cl < headerEnd) ? std::strtoul(buf.c_str() + cl + 16, nullptr, 10) : 0;
+            if (buf.size() >= headerEnd + 4 + length) {
+                bodies.push_back(buf.substr(headerEnd + 4, length));
+                buf.erase(0, headerEnd + 4 + length);
+                continue;
+            }
+        }
+        const ssize_t n = ::recv(fd, tmp, sizeof(tmp), 0);
+        if (n <= 0) break;
+        buf.append(tmp, static_cast<size_t>(n));
+    }
+    return bodies;
+}
+
+std::string delayRequest(int index, int delayMs) {
+    return "GET /delay?i=" + std::to_string(index) + "&ms=" + std::to_string(delayMs) +
+           " HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+}
+
+int queryInt(const std::string& target, const char* key) {
+    const auto pos = target.find(key);
+    return pos == std::string::npos ? 0 : std::atoi(target.c_str() + pos + std::strlen(key));
+}
+
+Response delayHandler(const ConnectionContext&, const HttpRequest& req) {
+    const int now = g_active.fetch_add(1) + 1;
+    int peak = g_peakActive.load();
+    while (now > peak && !g_peakActive.compare_exchange_weak(peak, now)) {}
+    std::this_thread::sleep_for(std::chrono::milliseconds(queryInt(req.target, "ms=")));
+    g_active.fetch_sub(1);
+    return HttpResponse::ok().contentType("text/plain").body(std::to_string(queryInt(req.target, "i="))).toResponse();
+}
+
+// 先发的请求耗时更长, worker 会倒序完成; 响应必须仍按 0..n-1 返回
+void checkOrdering() {
+    const int fd = connectTo(kPort);
+    CHECK(fd >= 0);
+    if (fd < 0) return;
+
+    const int n = 4;
+    std::string burst;
+    for (int i = 0; i < n; ++i) burst += delayRequest(i, (n - i) * 30);
+    CHECK(sendAll(fd, burst));
+    const auto bodies = readBodies(fd, n);
+    CHECK(bodies.size() == static_cast<size_t>(n));
+    for (size_t i = 0; i < bodies.size(); ++i) CHECK(bodies[i] == std::to_string(i));
+    ::close(fd);
+}
+
+// 一次写入 40 个请求, 同时在处理中的请求不超过 maxPipelinedRequests, 全部按序返回
+void checkInFlightCap() {
+    const int fd = connectTo(kPort);
+    CHECK(fd >= 0);
+    if (fd < 0) return;
+
+    g_peakActive.store(0);
+    const int n = 40;
+    std::string burst;
+    for (int i = 0; i < n; ++i) burst += delayRequest(i, (i * 7) % 5);
+    CHECK(sendAll(fd, burst));
+    const auto bodies = readBodies(fd, n);
+    CHECK(bodies.size() == static_cast<size_t>(n));
+    for (size_t i = 0; i < bodies.size(); ++i) CHECK(bodies[i] == std::to_string(i));
+    CHECK(g_peakActive.load() <= static_cast<int>(kMaxInFlight));
+    std::printf("peak concurrent handlers for one connection: %d (cap %u)\n", g_peakActive.load(), kMaxInFlight);
+    ::close(fd);
+}
+
+// 行协议批次同样按序返回
+void checkLineOrdering() {
+    const int fd = connectTo(kPort);
+    CHECK(fd >= 0);
+    if (fd < 0) return;
+
+    std::string all;
+    const int n = 200;
+    for (int i = 0; i < n; ++i) {
+        CHECK(sendAll(fd, "SLEEP " + std::to_string((n - i) % 3) + " " + std::to_string(i) + "\n"));
+    }
+    char tmp[4096];
+    int lines = 0;
+    while (lines < n) {
+        const ssize_t r = ::recv(fd, tmp, sizeof(tmp), 0);
+        if (r <= 0) break;
+        all.append(tmp, static_cast<size_t>(r));
+        lines = 0;
+        for (char ch : all) lines += (ch == '\n');
+    }
+    std::string expect;
+    for (int i = 0; i < n; ++i) expect += std::to_string(i) + "\n";
+    CHECK(all == expect);
+    ::close(fd);
+}
+
+// 读到对端关闭或超时为止
+std::string readUntilClosed(int fd) {
+    timeval tv{2, 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    std::string all;
+    char tmp[4096];
+    ssize_t n;
+    while ((n = ::recv(fd, tmp, sizeof(tmp), 0)) > 0) all.append(tmp, static_cast<size_t>(n));
+    return all;
+}
+
+// handler 抛异常: 该请求回 500 并断开, 之前的响应照常按序发出, 连接不会卡住
+void checkHandlerThrows() {
+    const int fd = connectTo(kPort);
+    CHECK(fd >= 0);
+    if (fd < 0) return;
+
+    CHECK(sendAll(fd, delayRequest(0, 30) + "GET /throw HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n" + delayRequest(2, 0)));
+    const std::string all = readUntilClosed(fd);
+    const auto ok = all.find("HTTP/1.1 200");
+    const auto err = all.find("HTTP/1.1 500");
+    CHECK(ok != std::string::npos);
+    CHECK(err != std::string::npos && err > ok);
+    CHECK(all.find("HTTP/1.1 200", ok + 1) == std::string::npos);
+    ::close(fd);
+}
+
+// 行协议: 抛异常的命令回错误行, 后续命令继续处理
+void checkLineHandlerThrows() {
+    const int fd = connectTo(kPort);
+    CHECK(fd >= 0);
+    if (fd < 0) return;
+
+    CHECK(sendAll(fd, "SLEEP 20 0\nBOOM\nSLEEP 0 2\n"));
+    timeval tv{2, 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    std::string all;
+    char tmp[256];
+    while (std::count(all.begin(), all.end(), '\n') < 3) {
+        const ssize_t n = ::recv(fd, tmp, sizeof(tmp), 0);
+        if (n <= 0) break;
+        all.append(tmp, static_cast<size_t>(n));
+    }
+    CHECK(all == "0\nERROR: Internal error\n2\n");
+    ::close(fd);
+}
+
+// 轮询客户端: n 个请求逐个往返 vs 一次 pipelined 发出
+void compareRoundTrips() {
+    const int fd = connectTo(kPort);
+    if (fd < 0) return;
+    const int n = 16;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) {
+        sendAll(fd, delayRequest(i, 1));
+        readBodies(fd, 1);
+    }
+    const double serialMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    std::string burst;
+    for (int i = 0; i < n; ++i) burst += delayRequest(i, 1);
+    t0 = std::chrono::steady_clock::now();
+    sendAll(fd, burst);
+    readBodies(fd, n);
+    const double pipelinedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    std::printf("%d polls with 1ms handlers: one-by-one %.1f ms, pipelined %.1f ms\n", n, serialMs, pipelinedMs);
+    ::close(fd);
+}
+
+} // namespace
+
+int main() {
+    utils::LoggerConfig loggerConfig = utils::LoggerConfig::defaultConfig();
+    loggerConfig.async = false;
+    loggerConfig.global_level = utils::LogLevel::WARN;
+    utils::LoggerV2::init(loggerConfig);
+
+    ServerConfig cfg;
+    cfg.bindAddress = "127.0.0.1";
+    cfg.port = kPort;
+    cfg.workerThreadsMin = 8;
+    cfg.workerThreadsMax = 8;
+    cfg.maxPipelinedRequests = kMaxInFlight;
+
+    Server server(cfg);
+    server.http().get("/delay", delayHandler);
+    server.line().on("SLEEP", [](const ConnectionContext&, const LineRequest& req) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(std::atoi(req.params.c_str())));
+        return Response::bytes(req.params.substr(req.params.find(' ') + 1) + "\n");
+    });
+    server.http().get("/throw", [](const ConnectionContext&, const HttpRequest&) -> Response {
+        throw std::runtime_error("handler failure");
+    });
+    server.line().on("BOOM", [](const ConnectionContext&, const LineRequest&) -> Response {
+        throw std::runtime_error("handler failure");
+    });
+    if (!server.start()) {
+        std::printf("start failed on port %u\n", kPort);
+        return 1;
+    }
+
+    checkOrdering();
+    checkInFlightCap();
+    checkLineOrdering();
+    checkHandlerThrows();
+    checkLineHandlerThrows();
+    compareRoundTrips();
+
+    server.stop();
+    server.join();
+    std::printf("pipeline checks: %s\n", g_errors == 0 ? "PASS" : "FAIL");
+    return g_errors == 0 ? 0 : 1;
+}
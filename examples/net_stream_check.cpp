@@ -0,0 +1,329 @@
+/*
+ * @FilePath: /examples/net_stream_check.cpp
+ * @Author: SweerItTer xxxzhou.xian@gmail.com
+ * @Date: 2026-03-15
+ * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
+ * @Description: 回环检查 chunked 请求解码与 BodyStream 流式响应:
+ *               分帧与顺序, 对端不读时生产端被反压, 对端断开时生产端被取消, abort() 关闭连接
+ */
+
+#include "logger_config.h"
+#include "logger_v2.h"
+#include "net/server.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace utils::net;
+
+namespace {
+
+constexpr uint16_t kPort = 18270;
+constexpr size_t kStreamBuffer = 64 * 1024;
+
+int g_errors = 0;
+std::mutex g_producersMutex;
+std::vector<std::thread> g_producers;
+std::atomic<uint64_t> g_floodWritten{0};
+std::atomic<bool> g_floodDone{false};
+std::atomic<bool> g_floodCancelled{false};
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::printf("  check failed: %s (line %d)\n", #cond, __LINE__); \
+            ++g_errors;                                                     \
+        }                                                                   \
+    } while (0)
+
+int connectTo(uint16_t port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (int attempt = 0; attempt < 50; ++attempt) {
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            return fd;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ::close(fd);
+    return -1;
+}
+
+bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        const ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void startProducer(std::function<void()> fn) {
+    std::lock_guard<std::mutex> lock(g_producersMutex);
+    g_producers.emplace_back(std::move(fn));
+}
+
+int queryInt(const std::string& target, const char* key) {
+    const auto pos = target.find(key);
+    return pos == std::string::npos ? 0 : std::atoi(target.c_str() + pos + std::strlen(key));
+}
+
+/*
+ * 最小响应读取器: 按 Content-Length 或 chunked 读出一个响应体.
+ * 返回 false 表示连接在响应完整之前关闭.
+ */
+class ResponseReader {
+public:
+    explicit ResponseReader(int fd) : fd_(fd) {}
+
+    bool next(std::string& head, std::string& body) {
+        size_t headerEnd;
+        while ((headerEnd = buf_.find("\r\n\r\n")) == std::string::npos) {
+            if (!fill()) return false;
+        }
+        head = buf_.substr(0, headerEnd + 4);
+        buf_.erase(0, headerEnd + 4);
+        body.clear();
+
+        if (head.find("Transfer-Encoding: chunked") == std::string::npos) {
+            const auto cl = head.find("Content-Length: ");
+            const size_t length = (cl == std::string::npos) ? 0 : std::strtoul(head.c_str() + cl + 16, nullptr, 10);
+            while (buf_.size() < length) {
+                if (!fill()) return false;
+            }
+            body = buf_.substr(0, length);
+            buf_.erase(0, length);
+            return true;
+        }
+
+        while (true) {
+            size_t lineEnd;
+            while ((lineEnd = buf_.find("\r\n")) == std::string::npos) {
+                if (!fill()) return false;
+            }
+            const size_t size = std::strtoul(buf_.c_str(), nullptr, 16);
+            while (buf_.size() < lineEnd + 2 + size + 2) {
+                if (!fill()) return false;
+            }
+            if (buf_.compare(lineEnd + 2 + size, 2, "\r\n") != 0) return false;
+            body.append(buf_, lineEnd + 2, size);
+            buf_.erase(0, lineEnd + 2 + size + 2);
+            ++chunks_;
+            if (size == 0) return true;
+        }
+    }
+
+    size_t chunks() const { return chunks_; }
+
+private:
+    bool fill() {
+        char tmp[65536];
+        const ssize_t n = ::recv(fd_, tmp, sizeof(tmp), 0);
+        if (n <= 0) return false;
+        buf_.append(tmp, static_cast<size_t>(n));
+        return true;
+    }
+
+    int fd_;
+    std::string buf_;
+    size_t chunks_{0};
+};
+
+// chunked 请求体分多次到达 (含 chunk-ext 与 trailer), 之后紧跟一个普通请求
+void checkChunkedRequest() {
+    const int fd = connectTo(kPort);
+    CHECK(fd >= 0);
+    if (fd < 0) return;
+
+    const std::string parts[] = {
+        "POST /echo HTTP/1.1\r\nHost: a\r\nTransfer-Encoding: chunked\r\n\r\n5;name=v",
+        "alue\r\nhello\r\n",
+        "7\r\n, world\r\n0\r\nX-Checksum: 1\r\n",
+        "\r\nGET /echo HTTP/1.1\r\n\r\n",
+    };
+    for (const auto& part : parts) {
+        CHECK(sendAll(fd, part));
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    ResponseReader reader(fd);
+    std::string head;
+    std::string body;
+    CHECK(reader.next(head, body) && body == "hello, world");
+    CHECK(reader.next(head, body) && body.empty());
+    ::close(fd);
+
+    // Content-Length 与 chunked 同时出现: 400 并关闭
+    const int bad = connectTo(kPort);
+    CHECK(sendAll(bad, "POST /echo HTTP/1.1\r\nContent-Length: 3\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nabc\r\n0\r\n\r\n"));
+    ResponseReader badReader(bad);
+    CHECK(badReader.next(head, body) && head.find(" 400 ") != std::string::npos);
+    CHECK(!badReader.next(head, body));
+    ::close(bad);
+}
+
+// 流式响应: 分块内容与顺序正确, 后续 pipelined 请求排在流结束之后
+void checkStreamedResponse() {
+    const int fd = connectTo(kPort);
+    CHECK(fd >= 0);
+    if (fd < 0) return;
+
+    CHECK(sendAll(fd, "GET /count?n=2000 HTTP/1.1\r\n\r\nGET /echo HTTP/1.1\r\n\r\n"));
+    ResponseReader reader(fd);
+    std::string head;
+    std::string body;
+    CHECK(reader.next(head, body));
+    CHECK(head.find("Content-Length") == std::string::npos);
+    std::string expect;
+    for (int i = 0; i < 2000; ++i) expect += std::to_string(i) + "\n";
+    CHECK(body == expect);
+    CHECK(reader.next(head, body) && head.find(" 200 ") != std::string::npos && body.empty());
+    std::printf("streamed %zu bytes in %zu chunks\n", expect.size(), reader.chunks());
+    ::close(fd);
+}
+
+// 客户端暂停读取时, 生产端被阻塞在 write(); 恢复读取后数据完整; 中途断开则生产端被取消
+void checkBackpressure() {
+    const int fd = connectTo(kPort);
+    CHECK(fd >= 0);
+    if (fd < 0) return;
+
+    const int totalMiB = 64;
+    g_floodWritten.store(0);
+    g_floodDone.store(false);
+    CHECK(sendAll(fd, "GET /flood?mib=" + std::to_string(totalMiB) + " HTTP/1.1\r\n\r\n"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    const uint64_t stalled = g_floodWritten.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    CHECK(g_floodWritten.load() == stalled); // 生产端已停下
+    CHECK(stalled < static_cast<uint64_t>(totalMiB) << 20);
+    std::printf("producer stalled at %.1f MiB of %d MiB while the client was not reading\n",
+                stalled / 1048576.0, totalMiB);
+
+    ResponseReader reader(fd);
+    std::string head;
+    std::string body;
+    CHECK(reader.next(head, body));
+    CHECK(body.size() == static_cast<size_t>(totalMiB) << 20);
+    CHECK(g_floodDone.load());
+
+    // 中途断开
+    g_floodCancelled.store(false);
+    CHECK(sendAll(fd, "GET /flood?mib=1024 HTTP/1.1\r\n\r\n"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ::close(fd);
+    for (int i = 0; i < 200 && !g_floodCancelled.load(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(g_floodCancelled.load());
+}
+
+// 生产端 abort(): 连接关闭, 客户端读不到结束块
+void checkAbort() {
+    const int fd = connectTo(kPort);
+    CHECK(fd >= 0);
+    if (fd < 0) return;
+    CHECK(sendAll(fd, "GET /abort HTTP/1.1\r\n\r\n"));
+    ResponseReader reader(fd);
+    std::string head;
+    std::string body;
+    CHECK(!reader.next(head, body));
+    ::close(fd);
+}
+
+} // namespace
+
+int main() {
+    utils::LoggerConfig loggerConfig = utils::LoggerConfig::defaultConfig();
+    loggerConfig.async = false;
+    loggerConfig.global_level = utils::LogLevel::WARN;
+    utils::LoggerV2::init(loggerConfig);
+
+    ServerConfig cfg;
+    cfg.bindAddress = "127.0.0.1";
+    cfg.port = kPort;
+    cfg.workerThreadsMin = 2;
+    cfg.workerThreadsMax = 4;
+    Server server(cfg);
+
+    server.http().on("POST", "/echo", [](const ConnectionContext&, const HttpRequest& req) {
+        return HttpResponse::ok().contentType("text/plain").body(req.body).toResponse();
+    });
+    server.http().get("/echo", [](const ConnectionContext&, const HttpRequest&) {
+        return HttpResponse::ok().toResponse();
+    });
+    server.http().get("/count", [](const ConnectionContext&, const HttpRequest& req) {
+        auto stream = std::make_shared<BodyStream>(kStreamBuffer);
+        const int n = queryInt(req.target, "n=");
+        startProducer([stream, n] {
+            for (int i = 0; i < n; ++i) {
+                if (!stream->write(std::to_string(i) + "\n")) return;
+                if (i % 100 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            stream->close();
+        });
+        return HttpResponse::ok().contentType("text/plain").bodyFromStream(stream).toResponse();
+    });
+    server.http().get("/flood", [](const ConnectionContext&, const HttpRequest& req) {
+        auto stream = std::make_shared<BodyStream>(kStreamBuffer);
+        const uint64_t total = static_cast<uint64_t>(queryInt(req.target, "mib=")) << 20;
+        startProducer([stream, total] {
+            const std::string block(64 * 1024, 'f');
+            for (uint64_t sent = 0; sent < total; sent += block.size()) {
+                if (!stream->write(block)) {
+                    g_floodCancelled.store(true);
+                    return;
+                }
+                g_floodWritten.fetch_add(block.size());
+            }
+            stream->close();
+            g_floodDone.store(true);
+        });
+        return HttpResponse::ok().bodyFromStream(stream).toResponse();
+    });
+    server.http().get("/abort", [](const ConnectionContext&, const HttpRequest&) {
+        auto stream = std::make_shared<BodyStream>();
+        stream->write("partial");
+        startProducer([stream] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            stream->abort();
+        });
+        return HttpResponse::ok().bodyFromStream(stream).toResponse();
+    });
+    if (!server.start()) {
+        std::printf("start failed on port %u\n", kPort);
+        return 1;
+    }
+
+    checkChunkedRequest();
+    checkStreamedResponse();
+    checkBackpressure();
+    checkAbort();
+
+    server.stop();
+    server.join();
+    for (auto& t : g_producers) t.join();
+    std::printf("stream checks: %s\n", g_errors == 0 ? "PASS" : "FAIL");
+    return g_errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+/*
+ * @FilePath: /examples/net_write_bench.cpp
+ * @Author: SweerItTer xxxzhou.xian@gmail.com
+ * @Date: 2026-03-14
+ * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
+ * @Description: 回环统计输出路径每个响应的写系统调用数与 epoll_ctl 次数 (Server::getStats),
+ *               场景: 小 JSON 一问一答 / 小 JSON pipelined / 静态文件 (sendfile)
+ *               用法: Net_Write_Bench [requests=20000]
+ */
+
+#include "logger_config.h"
+#include "logger_v2.h"
+#include "net/server.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace utils::net;
+
+namespace {
+
+constexpr uint16_t kPort = 18250;
+constexpr size_t kFileBytes = 16 * 1024;
+
+int connectTo(uint16_t port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (int attempt = 0; attempt < 50; ++attempt) {
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            return fd;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ::close(fd);
+    return -1;
+}
+
+bool writeAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        const ssize_t n = ::write(fd, data.data() + sent, data.size() - sent);
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// 按 Content-Length 读完 count 个响应, 剩余数据留在 buf
+bool readResponses(int fd, std::string& buf, int count) {
+    char tmp[65536];
+    while (count > 0) {
+        const auto headerEnd = buf.find("\r\n\r\n");
+        if (headerEnd != std::string::npos) {
+            const auto cl = buf.find("Content-Length: ");
+            const size_t length = (cl < headerEnd) ? std::strtoul(buf.c_str() + cl + 16, nullptr, 10) : 0;
+            if (buf.size() >= headerEnd + 4 + length) {
+                buf.erase(0, headerEnd + 4 + length);
+                --count;
+                continue;
+            }
+        }
+        const ssize_t n = ::read(fd, tmp, sizeof(tmp));
+        if (n <= 0) return false;
+        buf.append(tmp, static_cast<size_t>(n));
+    }
+    return true;
+}
+
+// 每次写入 depth 个请求并等待全部响应; 打印吞吐与每个响应的系统调用数
+bool run(Server& server, const char* name, const std::string& request, int requests, int depth) {
+    const int fd = connectTo(kPort);
+    if (fd < 0) return false;
+
+    std::string burst;
+    for (int i = 0; i < depth; ++i) burst += request;
+
+    const ServerStats before = server.getStats();
+    const auto t0 = std::chrono::steady_clock::now();
+    std::string buf;
+    bool ok = true;
+    uint64_t issued = 0;
+    for (; issued < static_cast<uint64_t>(requests) && ok; issued += depth) {
+        ok = writeAll(fd, burst) && readResponses(fd, buf, depth);
+    }
+    const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    ::close(fd);
+
+    // 计数在 send 返回后才递增, 客户端可能先读到数据
+    ServerStats after = server.getStats();
+    for (int i = 0; i < 100 && after.responsesSent - before.responsesSent < issued; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        after = server.getStats();
+    }
+
+    const double responses = static_cast<double>(after.responsesSent - before.responsesSent);
+    if (!ok || responses == 0) return false;
+    std::printf("%-22s %10.0f %14.2f %14.2f\n", name, responses / sec,
+                (after.writeSyscalls - before.writeSyscalls) / responses,
+                (after.pollUpdates - before.pollUpdates) / responses);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int requests = (argc >= 2) ? std::atoi(argv[1]) : 20000;
+
+    utils::LoggerConfig loggerConfig = utils::LoggerConfig::defaultConfig();
+    loggerConfig.async = false;
+    loggerConfig.global_level = utils::LogLevel::WARN;
+    utils::LoggerV2::init(loggerConfig);
+
+    char dir[] = "/tmp/net_write_bench.XXXXXX";
+    if (!::mkdtemp(dir)) return 1;
+    const std::string filePath = std::string(dir) + "/blob.bin";
+    {
+        const int fd = ::open(filePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return 1;
+        const std::string blob(kFileBytes, 'x');
+        const bool written = writeAll(fd, blob);
+        ::close(fd);
+        if (!written) return 1;
+    }
+
+    ServerConfig cfg;
+    cfg.bindAddress = "127.0.0.1";
+    cfg.port = kPort;
+    cfg.workerThreadsMin = 2;
+    cfg.workerThreadsMax = 2;
+    Server server(cfg);
+    server.http().get("/json", [](const ConnectionContext&, const HttpRequest&) {
+        return HttpResponse::ok()
+            .contentType("application/json")
+            .body("{\"camera\":0,\"fps\":30,\"temp\":41.5,\"ok\":true}")
+            .toResponse();
+    });
+    server.http().staticDir("/static/", dir);
+    if (!server.start()) {
+        std::printf("start failed on port %u\n", kPort);
+        return 1;
+    }
+
+    const std::string json = "GET /json HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+    const std::string file = "GET /static/blob.bin HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+
+    std::printf("=== %d requests over loopback, one keep-alive connection ===\n", requests);
+    std::printf("%-22s %10s %14s %14s\n", "scenario", "req/s", "writes/resp", "epoll_ctl/resp");
+    int failures = 0;
+    failures += !run(server, "json one-by-one", json, requests, 1);
+    failures += !run(server, "json pipelined x16", json, requests, 16);
+    failures += !run(server, "16KiB file one-by-one", file, requests / 4, 1);
+    failures += !run(server, "16KiB file pipelined x8", file, requests / 4, 8);
+
+    server.stop();
+    server.join();
+    ::unlink(filePath.c_str());
+    ::rmdir(dir);
+    return failures == 0 ? 0 : 1;
+}
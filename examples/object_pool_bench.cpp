@@ -0,0 +1,206 @@
+/*
+ * @FilePath: /examples/object_pool_bench.cpp
+ * @Author: SweerItTer xxxzhou.xian@gmail.com
+ * @Date: 2026-03-07
+ * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
+ * @Description: ObjectPool 与 LockFreeObjectPool 在 1/2/4/8 线程下的 acquire + release 吞吐对比,
+ *               以及有界增长 + BLOCK/FAIL 策略, creator 抛异常后槽位复用的行为检查
+ */
+
+#include "objectsPool.h"
+#include "lockFreeObjectPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 模拟编码参数/缓冲描述这类中等大小的可复用对象
+struct Payload {
+    int64_t fields[8] = {};
+};
+using PayloadPtr = std::unique_ptr<Payload>;
+
+constexpr size_t kPoolSize = 64;
+constexpr int kOpsPerThread = 500000;
+
+std::atomic<int> g_errors{0};
+
+template <typename Fn>
+double runThreads(int threads, Fn&& body) {
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) workers.emplace_back(body);
+    for (auto& w : workers) w.join();
+    const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return static_cast<double>(threads) * kOpsPerThread / sec;
+}
+
+PayloadPtr makePayload() { return PayloadPtr(new Payload()); }
+
+double benchLocked(int threads) {
+    ObjectPool<PayloadPtr> pool(kPoolSize, makePayload);
+    return runThreads(threads, [&pool] {
+        for (int i = 0; i < kOpsPerThread; ++i) {
+            PayloadPtr obj = pool.acquire();
+            obj->fields[0] += 1;
+            pool.release(std::move(obj));
+        }
+    });
+}
+
+double benchLockFreeValue(int threads) {
+    LockFreeObjectPool<PayloadPtr> pool(kPoolSize, makePayload);
+    return runThreads(threads, [&pool] {
+        for (int i = 0; i < kOpsPerThread; ++i) {
+            PayloadPtr obj = pool.acquire();
+            obj->fields[0] += 1;
+            pool.release(std::move(obj));
+        }
+    });
+}
+
+// 句柄接口: 对象留在池内, 直接存 Payload 而不是指针
+double benchLockFreeHandle(int threads) {
+    LockFreeObjectPool<Payload, Payload (*)()> pool(kPoolSize, [] { return Payload(); });
+    return runThreads(threads, [&pool] {
+        for (int i = 0; i < kOpsPerThread; ++i) {
+            auto handle = pool.acquireHandle();
+            handle->fields[0] += 1;
+        }
+    });
+}
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::printf("  check failed: %s (line %d)\n", #cond, __LINE__); \
+            g_errors.fetch_add(1);                                          \
+        }                                                                   \
+    } while (0)
+
+// 有界增长与耗尽策略
+void checkGrowth() {
+    using Pool = LockFreeObjectPool<int, int (*)()>;
+    {
+        Pool pool(2, [] { return 7; }, 4, Pool::ExhaustedPolicy::FAIL);
+        std::vector<Pool::Handle> held;
+        for (int i = 0; i < 4; ++i) {
+            held.push_back(pool.acquireHandle());
+            CHECK(held.back() && *held.back() == 7);
+        }
+        CHECK(pool.createdCount() == 4);
+        CHECK(!pool.acquireHandle());
+        // FAIL 策略下带超时的接口同样立即返回, 不等到超时
+        const auto t0 = std::chrono::steady_clock::now();
+        CHECK(!pool.tryAcquireHandle(std::chrono::milliseconds(500)));
+        int value = 0;
+        CHECK(!pool.tryAcquire(value, std::chrono::milliseconds(500)));
+        CHECK(std::chrono::steady_clock::now() - t0 < std::chrono::milliseconds(100));
+        held.pop_back();
+        CHECK(pool.freeCount() == 1);
+        CHECK(pool.acquireHandle());
+    }
+    {
+        Pool pool(1, [] { return 1; }, 1, Pool::ExhaustedPolicy::BLOCK);
+        Pool::Handle first = pool.acquireHandle();
+        std::atomic<bool> acquired{false};
+        std::thread waiter([&] {
+            Pool::Handle second = pool.acquireHandle();
+            acquired = static_cast<bool>(second);
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        CHECK(!acquired.load());
+        first.reset();
+        waiter.join();
+        CHECK(acquired.load());
+        CHECK(pool.freeCount() == 1);
+    }
+    {
+        // 按值接口与 ObjectPool 一致: 取走再放回
+        LockFreeObjectPool<PayloadPtr> pool(2, makePayload);
+        PayloadPtr a = pool.acquire();
+        PayloadPtr b;
+        CHECK(pool.tryAcquire(b, std::chrono::milliseconds(1)));
+        PayloadPtr c;
+        CHECK(!pool.tryAcquire(c, std::chrono::milliseconds(1)));
+        pool.release(std::move(a));
+        pool.release(std::move(b));
+        CHECK(pool.freeCount() == 2);
+    }
+}
+
+// creator 抛异常: 占用的槽位退回后可再次使用, 等待中的线程被唤醒后接手该槽位
+void checkThrowingCreator() {
+    using Pool = LockFreeObjectPool<int>;
+    {
+        std::atomic<int> failures{2};
+        Pool pool(0, [&failures]() -> int {
+            if (failures.fetch_sub(1) > 0) throw std::runtime_error("creator failed");
+            return 3;
+        }, 2, Pool::ExhaustedPolicy::BLOCK);
+        for (int i = 0; i < 2; ++i) {
+            bool threw = false;
+            try {
+                pool.acquireHandle();
+            } catch (const std::runtime_error&) {
+                threw = true;
+            }
+            CHECK(threw);
+        }
+        Pool::Handle a = pool.tryAcquireHandle(std::chrono::milliseconds(20));
+        Pool::Handle b = pool.tryAcquireHandle(std::chrono::milliseconds(20));
+        CHECK(a && b && *a == 3 && *b == 3);
+        CHECK(pool.createdCount() == 2);
+        CHECK(!pool.tryAcquireHandle(std::chrono::milliseconds(5)));
+    }
+    {
+        // 容量 1: 第一个线程构造中途失败时, 第二个线程已因 "已达上限" 阻塞
+        std::atomic<int> calls{0};
+        Pool pool(0, [&calls]() -> int {
+            if (calls.fetch_add(1) == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(30));
+                throw std::runtime_error("creator failed");
+            }
+            return 5;
+        }, 1, Pool::ExhaustedPolicy::BLOCK);
+        std::atomic<bool> firstThrew{false};
+        std::thread first([&] {
+            try {
+                pool.acquireHandle();
+            } catch (const std::runtime_error&) {
+                firstThrew = true;
+            }
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        Pool::Handle second = pool.acquireHandle();
+        first.join();
+        CHECK(firstThrew.load());
+        CHECK(second && *second == 5);
+        CHECK(pool.createdCount() == 1);
+    }
+}
+
+} // namespace
+
+int main() {
+    checkGrowth();
+    checkThrowingCreator();
+    std::printf("growth/policy checks: %s\n", g_errors.load() == 0 ? "PASS" : "FAIL");
+
+    std::printf("\n=== acquire + release, pool of %zu, %d ops/thread (Mops) ===\n", kPoolSize, kOpsPerThread);
+    std::printf("%-4s %12s %14s %14s\n", "N", "ObjectPool", "LockFree value", "LockFree handle");
+    const int threadCounts[] = {1, 2, 4, 8};
+    for (int n : threadCounts) {
+        const double locked = benchLocked(n);
+        const double value = benchLockFreeValue(n);
+        const double handle = benchLockFreeHandle(n);
+        std::printf("%-4d %12.2f %14.2f %14.2f\n", n, locked / 1e6, value / 1e6, handle / 1e6);
+    }
+    return g_errors.load() == 0 ? 0 : 1;
+}
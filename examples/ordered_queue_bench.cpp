@@ -0,0 +1,168 @@
+/*
+ * @FilePath: /examples/ordered_queue_bench.cpp
+ * @Author: SweerItTer xxxzhou.xian@gmail.com
+ * @Date: 2026-03-05
+ * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
+ * @Description: OrderedQueue 等待开销: 慢消费者下 BLOCK 生产者的 CPU 占用,
+ *               慢生产者下超时出队的 CPU 占用与唤醒延迟,
+ *               以及乱序完成时逐帧出队与 dequeue_run 整段出队的吞吐对比
+ */
+
+#include "orderedQueue.h"
+#include "internal/logLinearHistogram.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Frame {
+    int64_t sentNs = 0;
+};
+using Queue = OrderedQueue<Frame>;
+
+inline int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 当前线程累计 CPU 时间
+inline int64_t threadCpuNs() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+constexpr size_t kCapacity = 8;
+constexpr int kFrames = 400;
+constexpr int kIntervalUs = 1000;
+
+// 慢消费者: 4 个生产者乱序 BLOCK 入队, 消费者每帧处理 1ms, 返回生产者合计 CPU 占用(占一个核的百分比)
+double runSlowConsumer() {
+    constexpr int kProducers = 4;
+    Queue queue(kCapacity);
+    std::atomic<int64_t> producerCpuNs{0};
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&queue, &producerCpuNs, p] {
+            const int64_t cpu0 = threadCpuNs();
+            for (int id = p; id < kFrames; id += kProducers) {
+                queue.enqueue(static_cast<uint64_t>(id), Frame{}, Queue::OverflowPolicy::BLOCK);
+            }
+            producerCpuNs.fetch_add(threadCpuNs() - cpu0, std::memory_order_relaxed);
+        });
+    }
+    int got = 0;
+    Frame frame;
+    while (got < kFrames) {
+        if (!queue.try_dequeue(frame, 100)) continue;
+        ++got;
+        std::this_thread::sleep_for(std::chrono::microseconds(kIntervalUs));
+    }
+    for (auto& t : producers) t.join();
+    const double wallNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    return 100.0 * producerCpuNs.load() / wallNs;
+}
+
+// 慢生产者: 每 1ms 入队一帧, 消费者 try_dequeue(50ms) 等待, 统计消费者 CPU 占用与唤醒延迟
+double runSlowProducer(utils::internal::LogLinearHistogram& hist) {
+    Queue queue(kCapacity);
+    double consumerCpu = 0;
+
+    std::thread consumer([&] {
+        const int64_t cpu0 = threadCpuNs();
+        const auto t0 = std::chrono::steady_clock::now();
+        int got = 0;
+        Frame frame;
+        while (got < kFrames) {
+            if (!queue.try_dequeue(frame, 50)) continue;
+            hist.record(static_cast<uint64_t>(nowNs() - frame.sentNs));
+            ++got;
+        }
+        const double wallNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+        consumerCpu = 100.0 * (threadCpuNs() - cpu0) / wallNs;
+    });
+
+    auto next = std::chrono::steady_clock::now();
+    for (int id = 0; id < kFrames; ++id) {
+        next += std::chrono::microseconds(kIntervalUs);
+        std::this_thread::sleep_until(next);
+        Frame frame;
+        frame.sentNs = nowNs();
+        queue.enqueue(static_cast<uint64_t>(id), std::move(frame), Queue::OverflowPolicy::BLOCK);
+    }
+    consumer.join();
+    return consumerCpu;
+}
+
+// 4 个生产者乱序完成, 消费者逐帧(runs=false)或整段(runs=true)取出, 返回每秒帧数
+double runDrain(bool runs, Queue::Stats& stats, double& avgRun) {
+    constexpr int kProducers = 4;
+    constexpr int kBurstFrames = 200000;
+    Queue queue(64);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&queue, p] {
+            for (int id = p; id < kBurstFrames; id += kProducers) {
+                queue.enqueue(static_cast<uint64_t>(id), Frame{}, Queue::OverflowPolicy::BLOCK);
+            }
+        });
+    }
+    size_t got = 0, calls = 0;
+    std::vector<Frame> out;
+    Frame frame;
+    while (got < static_cast<size_t>(kBurstFrames)) {
+        size_t n = 0;
+        if (runs) {
+            out.clear();
+            n = queue.dequeue_run(out, SIZE_MAX, 10);
+        } else {
+            n = queue.try_dequeue(frame, 10) ? 1 : 0;
+        }
+        if (n > 0) {
+            got += n;
+            ++calls;
+        }
+    }
+    for (auto& t : producers) t.join();
+    const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    stats = queue.get_stats();
+    avgRun = calls > 0 ? static_cast<double>(got) / calls : 0.0;
+    return got / sec;
+}
+
+} // namespace
+
+int main() {
+    std::printf("=== OrderedQueue wait cost, capacity %zu, %d frames, 1 frame per %d us ===\n",
+                kCapacity, kFrames, kIntervalUs);
+
+    const double producerCpu = runSlowConsumer();
+    std::printf("slow consumer : 4 BLOCK producers CPU %6.2f%% of one core\n", producerCpu);
+
+    utils::internal::LogLinearHistogram hist;
+    const double consumerCpu = runSlowProducer(hist);
+    const auto lat = hist.snapshot();
+    std::printf("slow producer : waiting consumer CPU %6.2f%% of one core, "
+                "wake latency p50 %.1f us p99 %.1f us max %.1f us\n",
+                consumerCpu, lat.p50 / 1e3, lat.p99 / 1e3, lat.max / 1e3);
+
+    std::printf("\n=== out-of-order drain: 4 producers, capacity 64 ===\n");
+    std::printf("%-14s %10s %10s %12s %12s\n", "consumer", "Mframes/s", "avg run", "avg reorder", "max reorder");
+    for (bool runs : {false, true}) {
+        Queue::Stats stats;
+        double avgRun = 0;
+        const double rate = runDrain(runs, stats, avgRun);
+        std::printf("%-14s %10.2f %10.2f %12.2f %12lu\n", runs ? "dequeue_run" : "try_dequeue",
+                    rate / 1e6, avgRun, stats.avg_reorder_depth, stats.max_reorder_depth);
+    }
+    return 0;
+}
@@ -0,0 +1,214 @@
+/*
+ * @FilePath: /examples/queue_bench.cpp
+ * @Author: SweerItTer xxxzhou.xian@gmail.com
+ * @Date: 2026-03-02
+ * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
+ * @Description: SafeQueue 与 MpmcQueue 在 1/2/4/8 生产者 x 消费者下的吞吐对比,
+ *               以及 1:1 流水线边上 SpscQueue 与现有队列的吞吐/延迟对比
+ */
+
+#include "safeQueue.h"
+#include "mpmcQueue.h"
+#include "spscQueue.h"
+#include "concurrentqueue.h"
+#include "internal/logLinearHistogram.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Item {
+    int producer;
+    int seq;
+    int64_t sentNs;
+};
+using ItemPtr = std::unique_ptr<Item>;
+
+constexpr size_t kCapacity = 1024;
+constexpr int kItemsPerProducer = 200000;
+
+// threads 个生产者和 threads 个消费者, BLOCK 策略, 返回每秒完成的 enqueue+dequeue 对数
+template <typename Queue>
+double runContention(int threads) {
+    Queue queue(kCapacity, Queue::OverflowPolicy::BLOCK);
+
+    // 对象提前分配, 计时区间内只测队列本身
+    std::vector<std::vector<ItemPtr>> inputs(threads);
+    for (int p = 0; p < threads; ++p) {
+        inputs[p].reserve(kItemsPerProducer);
+        for (int i = 0; i < kItemsPerProducer; ++i) inputs[p].emplace_back(new Item{p, i, 0});
+    }
+    std::vector<std::vector<ItemPtr>> outputs(threads);
+    for (auto& out : outputs) out.reserve(static_cast<size_t>(kItemsPerProducer) * 2);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < threads; ++c) {
+        consumers.emplace_back([&queue, &outputs, c] {
+            while (ItemPtr item = queue.dequeue()) outputs[c].push_back(std::move(item));
+        });
+    }
+    std::vector<std::thread> producers;
+    for (int p = 0; p < threads; ++p) {
+        producers.emplace_back([&queue, &inputs, p] {
+            for (auto& item : inputs[p]) queue.enqueue(std::move(item));
+        });
+    }
+    for (auto& t : producers) t.join();
+    // dequeue 在队列清空后才因 shutdown 返回 nullptr
+    queue.shutdown();
+    for (auto& t : consumers) t.join();
+    const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    size_t total = 0;
+    for (const auto& out : outputs) total += out.size();
+    if (total != static_cast<size_t>(threads) * kItemsPerProducer) {
+        std::printf("  lost items: %zu / %d\n", total, threads * kItemsPerProducer);
+    }
+    return static_cast<double>(total) / sec;
+}
+
+// ---------------- 1:1 流水线边 ----------------
+// 统一的阻塞 push/pop/close 接口, pop 返回 false 表示已关闭且取空
+template <typename Queue>
+struct BlockingAdapter {
+    Queue q{kCapacity, Queue::OverflowPolicy::BLOCK};
+    void push(ItemPtr&& item) { q.enqueue(std::move(item)); }
+    bool pop(ItemPtr& item) { item = q.dequeue(); return item != nullptr; }
+    void close() { q.shutdown(); }
+};
+
+struct SpscAdapter {
+    SpscQueue<ItemPtr> q{kCapacity, true};
+    void push(ItemPtr&& item) { q.push(std::move(item)); }
+    bool pop(ItemPtr& item) { return q.pop(item); }
+    void close() { q.close(); }
+};
+
+// moodycamel 没有阻塞接口(FrameQueue 的用法), 消费者轮询 + yield
+struct MoodycamelAdapter {
+    moodycamel::ConcurrentQueue<ItemPtr> q{kCapacity};
+    std::atomic<bool> closed{false};
+    void push(ItemPtr&& item) { q.enqueue(std::move(item)); }
+    bool pop(ItemPtr& item) {
+        for (;;) {
+            if (q.try_dequeue(item)) return true;
+            if (closed.load(std::memory_order_acquire)) return q.try_dequeue(item);
+            std::this_thread::yield();
+        }
+    }
+    void close() { closed.store(true, std::memory_order_release); }
+};
+
+inline int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+constexpr int kSpscItems = 1000000;
+
+template <typename Adapter>
+double runSpscThroughput() {
+    Adapter queue;
+    std::vector<ItemPtr> inputs;
+    inputs.reserve(kSpscItems);
+    for (int i = 0; i < kSpscItems; ++i) inputs.emplace_back(new Item{0, i, 0});
+    std::vector<ItemPtr> outputs;
+    outputs.reserve(kSpscItems);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::thread consumer([&] {
+        ItemPtr item;
+        while (queue.pop(item)) outputs.push_back(std::move(item));
+    });
+    for (auto& item : inputs) queue.push(std::move(item));
+    queue.close();
+    consumer.join();
+    const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return outputs.size() / sec;
+}
+
+// 批量接口: 每次最多搬 32 个, 一次发布
+double runSpscBulkThroughput() {
+    SpscQueue<ItemPtr> queue(kCapacity);
+    std::vector<ItemPtr> inputs;
+    inputs.reserve(kSpscItems);
+    for (int i = 0; i < kSpscItems; ++i) inputs.emplace_back(new Item{0, i, 0});
+    std::vector<ItemPtr> outputs(kSpscItems);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::thread consumer([&] {
+        size_t got = 0;
+        while (got < outputs.size()) {
+            const size_t n = queue.try_pop_bulk(&outputs[got], std::min<size_t>(32, outputs.size() - got));
+            if (n == 0) std::this_thread::yield();
+            got += n;
+        }
+    });
+    size_t sent = 0;
+    while (sent < inputs.size()) {
+        const size_t n = queue.try_push_bulk(&inputs[sent], std::min<size_t>(32, inputs.size() - sent));
+        if (n == 0) std::this_thread::yield();
+        sent += n;
+    }
+    consumer.join();
+    const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return outputs.size() / sec;
+}
+
+// 按固定间隔发送带时间戳的元素, 统计 push -> pop 的延迟
+template <typename Adapter>
+utils::internal::LogLinearHistogram::Summary runSpscLatency(int items, int intervalUs) {
+    Adapter queue;
+    utils::internal::LogLinearHistogram hist;
+    std::thread consumer([&] {
+        ItemPtr item;
+        while (queue.pop(item)) hist.record(static_cast<uint64_t>(nowNs() - item->sentNs));
+    });
+    auto next = std::chrono::steady_clock::now();
+    for (int i = 0; i < items; ++i) {
+        next += std::chrono::microseconds(intervalUs);
+        std::this_thread::sleep_until(next);
+        queue.push(ItemPtr(new Item{0, i, nowNs()}));
+    }
+    queue.close();
+    consumer.join();
+    return hist.snapshot();
+}
+
+template <typename Adapter>
+void reportSpsc(const char* name) {
+    const double rate = runSpscThroughput<Adapter>();
+    const auto lat = runSpscLatency<Adapter>(2000, 100);
+    std::printf("%-22s %10.2f %10.1f %10.1f %10.1f\n", name, rate / 1e6,
+                lat.p50 / 1e3, lat.p99 / 1e3, lat.max / 1e3);
+}
+
+} // namespace
+
+int main() {
+    std::printf("=== queue contention: N producers x N consumers, capacity %zu, %d items/producer ===\n",
+                kCapacity, kItemsPerProducer);
+    std::printf("%-4s %16s %16s %8s\n", "N", "SafeQueue Mops", "MpmcQueue Mops", "speedup");
+    const int threadCounts[] = {1, 2, 4, 8};
+    for (int n : threadCounts) {
+        const double locked = runContention<SafeQueue<ItemPtr>>(n);
+        const double lockFree = runContention<MpmcQueue<ItemPtr>>(n);
+        std::printf("%-4d %16.2f %16.2f %7.2fx\n", n, locked / 1e6, lockFree / 1e6, lockFree / locked);
+    }
+
+    std::printf("\n=== 1 producer -> 1 consumer: %d items throughput, 2000 items @100us latency ===\n", kSpscItems);
+    std::printf("%-22s %10s %10s %10s %10s\n", "queue", "Mops", "p50 us", "p99 us", "max us");
+    reportSpsc<BlockingAdapter<SafeQueue<ItemPtr>>>("SafeQueue");
+    reportSpsc<BlockingAdapter<MpmcQueue<ItemPtr>>>("MpmcQueue");
+    reportSpsc<MoodycamelAdapter>("moodycamel (poll)");
+    reportSpsc<SpscAdapter>("SpscQueue (futex)");
+    std::printf("%-22s %10.2f\n", "SpscQueue bulk x32", runSpscBulkThroughput() / 1e6);
+    return 0;
+}
@@ -0,0 +1,148 @@
+/*
+ * @FilePath: /examples/simple_variant_check.cpp
+ * @Author: SweerItTer xxxzhou.xian@gmail.com
+ * @Date: 2026-03-09
+ * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
+ * @Description: SimpleVariant 共用存储: 大小/对齐, 以及非平凡类型的构造/析构/拷贝次数检查
+ */
+
+#include "simpleVariant.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+int g_errors = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            std::printf("  check failed: %s (line %d)\n", #cond, __LINE__); \
+            ++g_errors;                                                     \
+        }                                                                   \
+    } while (0)
+
+// 记录存活对象数与拷贝/移动次数
+struct Tracked {
+    static int alive;
+    static int copies;
+    static int moves;
+
+    int value = 0;
+    explicit Tracked(int v) : value(v) { ++alive; }
+    Tracked(const Tracked& o) : value(o.value) { ++alive; ++copies; }
+    Tracked(Tracked&& o) noexcept : value(o.value) { ++alive; ++moves; }
+    ~Tracked() { --alive; }
+};
+int Tracked::alive = 0;
+int Tracked::copies = 0;
+int Tracked::moves = 0;
+
+// 对齐要求大于其他成员的类型
+struct alignas(32) Wide {
+    double lanes[4] = {};
+};
+
+template <typename... Types>
+constexpr size_t maxSize() {
+    size_t m = 0;
+    for (size_t s : {sizeof(Types)...}) m = s > m ? s : m;
+    return m;
+}
+
+void checkLayout() {
+    using Prop = SimpleVariant<int, uint32_t, float>;
+    // 旧实现每个类型各占一份(int + uint32_t + float + index = 16 字节), 现在只占最大成员 + index
+    static_assert(sizeof(Prop) == 8, "int/uint32_t/float should share 4 bytes of storage");
+    static_assert(alignof(Prop) == alignof(int), "alignment follows the strictest member");
+
+    using Mixed = SimpleVariant<char, Wide, std::string>;
+    static_assert(alignof(Mixed) == alignof(Wide), "alignment follows the strictest member");
+    static_assert(sizeof(Mixed) <= maxSize<char, Wide, std::string>() + alignof(Wide),
+                  "storage is the largest member plus the index");
+
+    Mixed m{Wide{}};
+    CHECK(reinterpret_cast<uintptr_t>(&m) % alignof(Wide) == 0);
+    std::printf("sizeof(SimpleVariant<int, uint32_t, float>) = %zu\n", sizeof(Prop));
+    std::printf("sizeof(SimpleVariant<char, Wide, std::string>) = %zu (max member %zu)\n",
+                sizeof(Mixed), maxSize<char, Wide, std::string>());
+}
+
+void checkAccess() {
+    using Prop = SimpleVariant<int, uint32_t, float>;
+    Prop empty;
+    CHECK(empty.index() == -1);
+
+    Prop v(static_cast<uint32_t>(1920));
+    CHECK(v.index() == 1);
+    CHECK(v.holds<uint32_t>());
+    CHECK(v.get<uint32_t>() == 1920u);
+
+    bool threw = false;
+    try {
+        (void)v.get<float>();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    v.set(0.5f);
+    CHECK(v.index() == 2);
+    CHECK(v.get<float>() == 0.5f);
+
+    // 非 const 左值拷贝应走拷贝构造而不是模板构造
+    Prop copy(v);
+    CHECK(copy.get<float>() == 0.5f);
+}
+
+void checkLifetime() {
+    using V = SimpleVariant<int, Tracked, std::string>;
+    {
+        V v{Tracked(1)};
+        CHECK(Tracked::alive == 1);
+        CHECK(v.get<Tracked>().value == 1);
+        CHECK(Tracked::alive == 1);  // get 返回的临时对象已析构
+
+        V c(v);
+        CHECK(Tracked::alive == 2);
+
+        V m(std::move(c));
+        CHECK(Tracked::alive == 3);  // 被移动的对象仍持有(已移出的)值, 直到析构
+
+        // 切换成其他类型时析构旧值
+        v.set(std::string(64, 'x'));
+        CHECK(Tracked::alive == 2);
+        CHECK(v.get<std::string>().size() == 64);
+
+        v = m;
+        CHECK(Tracked::alive == 3);
+        v.set(7);
+        CHECK(Tracked::alive == 2);
+
+        std::vector<V> many;
+        for (int i = 0; i < 100; ++i) {
+            if (i % 2) many.emplace_back(Tracked(i));
+            else many.emplace_back(std::to_string(i) + std::string(40, 'y'));
+        }
+        CHECK(Tracked::alive == 52);
+        many.erase(many.begin(), many.begin() + 50);
+        CHECK(Tracked::alive == 27);
+    }
+    CHECK(Tracked::alive == 0);
+    std::printf("Tracked copies = %d, moves = %d\n", Tracked::copies, Tracked::moves);
+}
+
+} // namespace
+
+int main() {
+    checkLayout();
+    checkAccess();
+    checkLifetime();
+    std::printf("SimpleVariant checks: %s\n", g_errors == 0 ? "PASS" : "FAIL");
+    return g_errors == 0 ? 0 : 1;
+}
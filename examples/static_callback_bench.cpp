@@ -0,0 +1,129 @@
+/*
+ * @FilePath: /examples/static_callback_bench.cpp
+ * @Author: SweerItTer xxxzhou.xian@gmail.com
+ * @Date: 2026-03-08
+ * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
+ * @Description: StaticCallback 内联存储: 绑定时的堆分配次数与调用开销, 对比 std::function
+ */
+
+#include "internal/staticCallback.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <vector>
+
+// 统计本进程所有 operator new 调用
+static std::atomic<uint64_t> g_allocs{0};
+
+void* operator new(std::size_t size) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+using Callback = utils::internal::StaticCallback<void(int)>;
+
+struct Sink {
+    int64_t total = 0;
+    void release(int index) { total += index; }
+};
+
+constexpr int kBinds = 100000;
+constexpr int kCalls = 20000000;
+
+// 每次绑定一个新回调(模拟每帧设置 ReleaseCallback), 返回平均每次绑定的分配次数
+template <typename Fn, typename Make>
+double allocsPerBind(Make&& make) {
+    std::vector<Fn> slots(16);
+    const uint64_t before = g_allocs.load(std::memory_order_relaxed);
+    for (int i = 0; i < kBinds; ++i) slots[i & 15] = make(i);
+    return static_cast<double>(g_allocs.load(std::memory_order_relaxed) - before) / kBinds;
+}
+
+template <typename Fn>
+double nsPerCall(const Fn& fn) {
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kCalls; ++i) fn(i);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / kCalls;
+}
+
+template <typename Make>
+void report(const char* name, Make&& make) {
+    const double staticAllocs = allocsPerBind<Callback>(make);
+    const double functionAllocs = allocsPerBind<std::function<void(int)>>(make);
+    const Callback staticFn(make(1));
+    const std::function<void(int)> stdFn(make(1));
+    std::printf("%-26s %12.2f %12.2f %12.2f %12.2f\n", name, staticAllocs, functionAllocs,
+                nsPerCall(staticFn), nsPerCall(stdFn));
+}
+
+} // namespace
+
+int main() {
+    Sink sink;
+    int64_t extra[4] = {1, 2, 3, 4};
+    std::shared_ptr<Sink> shared = std::make_shared<Sink>();
+
+    std::printf("=== bind: %d rebinds, call: %d calls ===\n", kBinds, kCalls);
+    std::printf("%-26s %12s %12s %12s %12s\n", "capture", "Static alloc", "std alloc", "Static ns", "std ns");
+
+    report("[this] (1 ptr)", [&sink](int) {
+        return [s = &sink](int i) { s->release(i); };
+    });
+    report("[this, a, b] (3 ptrs)", [&sink, &extra](int n) {
+        return [s = &sink, a = &extra[0], b = n](int i) { s->release(i + static_cast<int>(*a) + b); };
+    });
+    report("[this, a, b, c] (4 ptrs)", [&sink, &extra](int n) {
+        return [s = &sink, a = &extra[0], b = &extra[1], c = n](int i) {
+            s->release(i + static_cast<int>(*a + *b) + c);
+        };
+    });
+    report("[shared_ptr] (heap)", [&shared](int) {
+        return [p = shared](int i) { p->release(i); };
+    });
+
+    Callback member = Callback::bindMember<Sink, &Sink::release>(&sink);
+    std::printf("%-26s %12s %12s %12.2f\n", "bindMember", "0", "-", nsPerCall(member));
+
+    // 原对象销毁后拷贝仍可调用 (内联 callable 按字节复制到拷贝自己的缓冲区)
+    Callback copy;
+    {
+        Callback original([s = &sink, k = 3](int i) { s->release(i * k); });
+        copy = original;
+    }
+    const int64_t before = sink.total;
+    copy(2);
+    bool ok = sink.total - before == 6;
+    std::printf("copy after original destroyed: %s\n", ok ? "PASS" : "FAIL");
+
+    // 拷贝语义: mutable lambda 的状态在拷贝间共享, 小 callable 与大 callable 一致
+    int observed = 0;
+    Callback smallOriginal([n = 0, out = &observed](int) mutable { *out = ++n; });
+    Callback smallCopy(smallOriginal);
+    smallOriginal(0);
+    smallCopy(0);
+    const bool smallShared = observed == 2;
+
+    observed = 0;
+    Callback largeOriginal([n = 0, out = &observed, extra](int) mutable { *out = ++n + static_cast<int>(extra[0] - 1); });
+    Callback largeCopy(largeOriginal);
+    largeOriginal(0);
+    largeCopy(0);
+    const bool largeShared = observed == 2;
+
+    std::printf("mutable copy shares state: small %s, large %s\n", smallShared ? "PASS" : "FAIL",
+                largeShared ? "PASS" : "FAIL");
+    ok = ok && smallShared && largeShared;
+    return ok ? 0 : 1;
+}
@@ -57,6 +57,7 @@ int main(int argc, char* argv[]) {
     LOG_INFO("Try    : curl http://127.0.0.1:%d/api/ping", runtimeConfig.server.port);
     LOG_INFO("Try    : curl -X POST http://127.0.0.1:%d/api/echo -H 'Content-Type: application/json' -d '{\"message\":\"Hello\"}'",
              runtimeConfig.server.port);
+    LOG_INFO("Try    : curl http://127.0.0.1:%d/api/hello/world", runtimeConfig.server.port);
     LOG_INFO("Try    : curl http://127.0.0.1:%d/static/index.html", runtimeConfig.server.port);
     LOG_INFO("Try    : curl -OJ http://127.0.0.1:%d/download/sample.txt", runtimeConfig.server.port);
     LOG_INFO("Press Ctrl+C to stop.");
@@ -3,19 +3,114 @@
  * @Author: SweerItTer xxxzhou.xian@gmail.com
  * @Date: 2026-02-22
  * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
- * @Description: asyncThreadPool 自动扩/缩容演示
+ * @Description: asyncThreadPool 自动扩/缩容演示 + 突发负载下的排队/执行耗时直方图 + 工作线程放置策略检查
  */
 
 #include "asyncThreadPool.h"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cstdio>
 #include <future>
 #include <mutex>
+#include <pthread.h>
+#include <sched.h>
+#include <set>
 #include <thread>
+#include <string>
 #include <unordered_set>
 #include <vector>
 
+static void printSummary(const char* name, const asyncThreadPool::HistogramSummary& s, double scale, const char* unit) {
+    std::printf("  %-11s n=%-7llu p50=%9.1f%s p90=%9.1f%s p99=%9.1f%s max=%9.1f%s\n",
+                name, (unsigned long long)s.count,
+                s.p50 / scale, unit, s.p90 / scale, unit, s.p99 / scale, unit, s.max / scale, unit);
+}
+
+static void printInstrumentation(const char* title, const asyncThreadPool& pool) {
+    const auto snap = pool.getInstrumentation();
+    const auto stats = pool.getPoolStats();
+    std::printf("[%s] threads=%zu added=%llu removed=%llu stolen=%llu\n", title, stats.aliveThreads,
+                (unsigned long long)stats.threadsAdded, (unsigned long long)stats.threadsRemoved,
+                (unsigned long long)stats.stolenTasks);
+    printSummary("wait", snap.waitNs, 1000.0, "us");
+    printSummary("exec", snap.execNs, 1000.0, "us");
+    printSummary("queueDepth", snap.queueDepth, 1.0, "  ");
+}
+
+// 模拟一帧内的 CPU 工作: 忙等 us 微秒, 避免 sleep 的调度误差干扰执行时间统计
+static void spinFor(int us) {
+    const auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(us);
+    while (std::chrono::steady_clock::now() < end) {
+    }
+}
+
+// 突发负载: 每 periodMs 一次性投递 burstTasks 个任务, 其余时间空闲
+static void runBurstyLoad(asyncThreadPool& pool, int bursts, int burstTasks, int taskUs, int periodMs) {
+    std::atomic<int> done{0};
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int b = 0; b < bursts; ++b) {
+        const auto next = t0 + std::chrono::milliseconds(periodMs * (b + 1));
+        pool.post_bulk(static_cast<size_t>(burstTasks), [&done, taskUs](size_t) {
+            spinFor(taskUs);
+            done.fetch_add(1, std::memory_order_relaxed);
+        });
+        std::this_thread::sleep_until(next);
+    }
+    while (done.load(std::memory_order_relaxed) < bursts * burstTasks) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// 同一突发负载在不同扩缩容策略下的排空时间
+static long long measureDrainMs(const asyncThreadPool::ScalingPolicy& policy, int tasks, int sleepMs) {
+    asyncThreadPool pool(1, 8, 4096, policy);
+    std::atomic<int> done{0};
+    const auto t0 = std::chrono::steady_clock::now();
+    pool.post_bulk(static_cast<size_t>(tasks), [&done, sleepMs](size_t) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(sleepMs));
+        done.fetch_add(1, std::memory_order_relaxed);
+    });
+    while (done.load(std::memory_order_relaxed) < tasks) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return (long long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - t0).count();
+}
+
+// 在任务内部读取 sched_getaffinity/线程名, 检查放置策略是否生效
+static void checkPlacement() {
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    asyncThreadPool::PlacementPolicy placement;
+    placement.cpus = {0, static_cast<int>(hw - 1)};
+    placement.pinEachWorker = true;
+    placement.niceValue = 5;
+    placement.threadName = "demo";
+    asyncThreadPool pool(2, 2, 64, asyncThreadPool::ScalingPolicy(), placement);
+
+    std::printf("\n=== placement: pinEachWorker on cores {0,%u}, nice 5 ===\n", hw - 1);
+    std::vector<std::future<std::string>> results;
+    for (int i = 0; i < 8; ++i) {
+        results.emplace_back(pool.enqueue([] {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            sched_getaffinity(0, sizeof(set), &set);
+            std::string cores;
+            for (int c = 0; c < CPU_SETSIZE; ++c) {
+                if (CPU_ISSET(c, &set)) cores += (cores.empty() ? "" : ",") + std::to_string(c);
+            }
+            char name[16] = {};
+            pthread_getname_np(pthread_self(), name, sizeof(name));
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            return std::string(name) + " -> cpus {" + cores + "}";
+        }));
+    }
+    std::set<std::string> seen;
+    for (auto& f : results) seen.insert(f.get());
+    for (const auto& line : seen) std::printf("  %s\n", line.c_str());
+}
+
 static size_t runBurst(asyncThreadPool& pool, int tasks, int sleepMs) {
     std::mutex mtx;
     std::unordered_set<std::thread::id> workers;
@@ -37,12 +132,15 @@ static size_t runBurst(asyncThreadPool& pool, int tasks, int sleepMs) {
 }
 
 int main() {
+    checkPlacement();
+
     asyncThreadPool pool(1, 8, 4096);
 
     std::printf("=== asyncThreadPool scale demo ===\n");
     std::printf("aliveThreads(init) = %zu\n", pool.aliveThreadCount());
 
-    // Burst1 must last longer than MANAGERINTERVAL (5s) so the manager thread has a chance to expand.
+    // With the default reactive policy the backlog check at submit time wakes the manager immediately,
+    // so expansion should be visible within the first second instead of after MANAGERINTERVAL (5s).
     const auto t1 = std::chrono::steady_clock::now();
     const int burst1Tasks = 128;
     const int burst1SleepMs = 120; // ~15s with 1 thread, but should shrink with expansion
@@ -85,5 +183,39 @@ int main() {
     std::printf("[Burst2] unique worker threads seen = %zu\n", burst2Workers);
     std::printf("aliveThreads(after burst2) = %zu\n", pool.aliveThreadCount());
 
+    // ---------------- 排空时间: 周期检查 vs 事件驱动 ----------------
+    std::printf("\n=== time-to-drain: 256 tasks x 20ms, threads 1..8 ===\n");
+    std::printf("periodic (MANAGERINTERVAL=%lldms): %lld ms\n",
+                (long long)MANAGERINTERVAL.count(),
+                measureDrainMs(asyncThreadPool::ScalingPolicy::periodic(), 256, 20));
+    std::printf("reactive (default policy)        : %lld ms\n",
+                measureDrainMs(asyncThreadPool::ScalingPolicy(), 256, 20));
+
+    // ---------------- 突发负载直方图 ----------------
+    // 同一负载分别跑在固定 1 线程和固定 4 线程的池上, 对比排队时间与执行时间的占比;
+    // 弹性池多跑几轮, 让 manager 有时间完成扩容再观察稳态
+    const int burstTasks = 64;
+    const int taskUs = 200;
+    const int periodMs = 50;
+    const int fixedBursts = 20;
+    const int elasticBursts = 120;
+    std::printf("\n=== bursty load: %d tasks x %dus per burst, period %dms ===\n", burstTasks, taskUs, periodMs);
+    const size_t fixedSizes[] = {1, 4};
+    char title[48];
+    for (size_t threads : fixedSizes) {
+        asyncThreadPool bench(threads, threads, 4096);
+        bench.setInstrumentation(true);
+        runBurstyLoad(bench, fixedBursts, burstTasks, taskUs, periodMs);
+        std::snprintf(title, sizeof(title), "fixed %zu thread(s), %d bursts", threads, fixedBursts);
+        printInstrumentation(title, bench);
+    }
+
+    // 弹性池: 观察 manager 的扩容决定对排队时间的影响
+    pool.resetInstrumentation();
+    pool.setInstrumentation(true);
+    runBurstyLoad(pool, elasticBursts, burstTasks, taskUs, periodMs);
+    std::snprintf(title, sizeof(title), "elastic 1..8, %d bursts", elasticBursts);
+    printInstrumentation(title, pool);
+
     return 0;
 }
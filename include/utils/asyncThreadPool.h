@@ -14,22 +14,33 @@
 #include <condition_variable>
 #include <future>
 #include <functional>
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <memory>
 #include <stdexcept>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <utility>
 #include "concurrentqueue.h"
 #include "internal/callbackTraits.h"
 #include "internal/staticCallback.h"
+#include "internal/workStealingDeque.h"
+#include "internal/smallBlockPool.h"
+#include "internal/logLinearHistogram.h"
 
-// 管理线程检查间隔
+// 管理线程检查间隔(旧的纯周期模式, 见 ScalingPolicy::periodic)
 static constexpr std::chrono::milliseconds MANAGERINTERVAL = std::chrono::milliseconds(5000);
 
 /**
  * @brief 异步线程池类
  * 
  * 线程池管理一组工作线程, 可动态伸缩.
- * 支持任务优先级, 用户可选择阻塞或非阻塞入队.
+ * 每个工作线程持有一个 Chase-Lev 本地队列, 工作线程内部投递的任务直接压入本地队列,
+ * 外部线程投递的任务进入无锁全局注入队列, 空闲线程随机窃取其他线程的本地任务.
+ * 支持 High/Normal/Background 三级优先级(见 Priority), 用户可选择阻塞或非阻塞入队.
  */
 class asyncThreadPool {
 public:
@@ -37,20 +48,141 @@ public:
     // 目标是保留原有 enqueue/try_enqueue 用法,同时让热点任务避免落到 std::function<void()>.
     using TaskCallback = utils::internal::StaticCallback<void()>;
 
+    /**
+     * @brief 扩缩容策略
+     *
+     * 扩容由事件驱动: 提交时 backlog 超过阈值, 或任务开始时等待时间超过阈值, 立即唤醒 manager;
+     * 缩容带滞回: 低负载持续 scaleDownDelay 后, 才回收空闲超过 idleTimeout 的线程.
+     * checkInterval 是没有事件时 manager 的兜底检查周期.
+     */
+    struct ScalingPolicy {
+        std::chrono::milliseconds checkInterval{500};    // manager 兜底检查周期
+        size_t backlogPerThread = 2;                     // 挂起任务数 > 线程数 * 该值时触发扩容, 0 关闭
+        std::chrono::microseconds waitThreshold{0};      // 任务等待超过该值时触发扩容, 0 关闭(开启后每次提交多一次时钟读取)
+        std::chrono::milliseconds idleTimeout{2000};     // 线程空闲超过该时间才可被回收
+        std::chrono::milliseconds scaleDownDelay{1000};  // 低负载需持续该时间才开始缩容
+
+        // 旧行为: 每 MANAGERINTERVAL 检查一次, 无事件触发
+        static ScalingPolicy periodic() {
+            ScalingPolicy p;
+            p.checkInterval = MANAGERINTERVAL;
+            p.backlogPerThread = 0;
+            p.scaleDownDelay = std::chrono::milliseconds(0);
+            return p;
+        }
+    };
+
+    /**
+     * @brief 工作线程放置策略, 每个工作线程启动时(包括扩容新建的线程)在自身线程内应用
+     *
+     * 默认不做任何修改. 设置失败(核号不在 cgroup 允许范围, 缺少 CAP_SYS_NICE 等)只打印警告, 线程照常运行.
+     */
+    struct PlacementPolicy {
+        std::vector<int> cpus;          // 允许运行的核心集合, 空表示不限制
+        bool pinEachWorker = false;     // true: 槽位 i 的线程固定到 cpus[i % cpus.size()], 避免核间迁移
+        int niceValue = 0;              // nice 值(-20 ~ 19), 0 表示不修改
+        int realtimePriority = 0;       // > 0 时切换到 SCHED_FIFO(1 ~ 99), 优先于 niceValue
+        std::string threadName;         // 线程名前缀, 工作线程命名为 "<前缀>-<槽位>", 空表示不命名
+    };
+
     /**
      * @brief 构造线程池
      * 
      * @param minThreads 最小线程数
      * @param maxThreads 最大线程数
      * @param maxQueueSize 队列最大长度
+     * @param policy 扩缩容策略, 默认事件驱动扩容
+     * @param placement 工作线程的 CPU 亲和性/调度类/线程名
      */
     asyncThreadPool(std::size_t minThreads=-1, std::size_t maxThreads=-1, std::size_t maxQueueSize = 64);
+    asyncThreadPool(std::size_t minThreads, std::size_t maxThreads, std::size_t maxQueueSize,
+                    const ScalingPolicy& policy);
+    asyncThreadPool(std::size_t minThreads, std::size_t maxThreads, std::size_t maxQueueSize,
+                    const ScalingPolicy& policy, const PlacementPolicy& placement);
 
     /**
      * @brief 析构函数, 停止线程池
      */
     ~asyncThreadPool();
 
+    /**
+     * @brief 任务优先级通道
+     *
+     * High:       每帧转换等延迟敏感任务, 优先出队, 并在队列中预留 maxQueueSize/8 的名额
+     * Normal:     默认通道, 工作线程内部投递时走本地队列
+     * Background: JPEG 快照/日志/整理等批量任务, 最多占用 maxQueueSize 的一半
+     * 出队时周期性先检查低优先级通道, 保证高负载下低优先级任务不会被饿死.
+     */
+    enum class Priority : uint8_t {
+        High = 0,
+        Normal = 1,
+        Background = 2,
+    };
+    static constexpr std::size_t kPriorityCount = 3;
+
+    /**
+     * @brief 协作式取消令牌, 拷贝共享同一个取消状态
+     *
+     * 任务开始前已取消则直接丢弃不执行; 已开始的长任务可自行轮询 isCancelled() 提前返回.
+     * 默认构造的空令牌永远不会被取消, 不产生任何分配.
+     */
+    class CancellationToken {
+    public:
+        CancellationToken() noexcept = default;
+        CancellationToken(const CancellationToken& other) noexcept : state_(retain(other.state_)) {}
+        CancellationToken(CancellationToken&& other) noexcept : state_(other.state_) { other.state_ = nullptr; }
+        CancellationToken& operator=(CancellationToken other) noexcept {
+            std::swap(state_, other.state_);
+            return *this;
+        }
+        ~CancellationToken() { release(state_); }
+
+        static CancellationToken create() { return CancellationToken(new State()); }
+
+        void cancel() const noexcept {
+            if (state_) state_->cancelled.store(true, std::memory_order_release);
+        }
+        bool isCancelled() const noexcept {
+            return state_ && state_->cancelled.load(std::memory_order_acquire);
+        }
+        explicit operator bool() const noexcept { return state_ != nullptr; }
+
+    private:
+        friend class asyncThreadPool;
+
+        // 侵入式引用计数, 任务节点只需保存一个指针
+        struct State {
+            std::atomic<bool> cancelled{false};
+            std::atomic<uint32_t> refs{1};
+        };
+
+        explicit CancellationToken(State* state) noexcept : state_(state) {}
+
+        static State* retain(State* state) noexcept {
+            if (state) state->refs.fetch_add(1, std::memory_order_relaxed);
+            return state;
+        }
+        static void release(State* state) noexcept {
+            if (state && state->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) delete state;
+        }
+
+        State* state_ = nullptr;
+    };
+
+    /**
+     * @brief 单个任务的提交选项
+     *
+     * deadline: 出队时已超过截止时间的任务不执行直接丢弃(实时帧处理中迟到的结果没有意义);
+     * token:    出队时已取消的任务同样丢弃.
+     * 被丢弃任务的 future 得到 std::future_error(broken_promise), 丢弃数计入 PoolStats.
+     * 已开始执行的任务不会被打断.
+     */
+    struct TaskOptions {
+        Priority priority = Priority::Normal;
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+        CancellationToken token;
+    };
+
     /**
      * @brief 阻塞入队任务(如果队列满, 会等待)
      * 
@@ -63,76 +195,71 @@ public:
     template<class F, class... Args>
     auto enqueue(F&& f, Args&&... args)
         -> std::future<typename std::result_of<F(Args...)>::type>
+    {
+        return enqueue(Priority::Normal, std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    template<class F, class... Args>
+    auto enqueue(Priority priority, F&& f, Args&&... args)
+        -> std::future<typename std::result_of<F(Args...)>::type>
     {
         using callableType = typename std::decay<F>::type;
         static_assert(
             utils::internal::is_invocable<callableType&, Args...>::value,
             "ThreadPool task must be invocable with the supplied argument types");
         using resultType = typename std::result_of<F(Args...)>::type;
-        // 仍然使用 packaged_task 保留 future 语义,但真正入队的是静态绑定后的 TaskCallback.
-        using taskType = std::packaged_task<resultType()>;
-        auto taskPtr = std::make_shared<taskType>(
-            std::bind(std::forward<F>(f), std::forward<Args>(args)...)
-        );
-
-        std::future<resultType> res = taskPtr->get_future();
-        std::unique_lock<std::mutex> lock(queueMtx_);
-
         // 阻塞直到队列有空位
-        queueNotFullCv_.wait(lock, [this]{ return tasks_.size_approx() < maxQueueSize_ || !running_; });
-
-        if(!running_) return std::future<resultType>();
-
-        tasks_.enqueue(TaskCallback::template bindShared<taskType, &taskType::operator()>(taskPtr));
-        workerCv_.notify_one();
+        return enqueueImpl<resultType>(priority, true,
+            std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+    }
 
-        return res;
+    template<class F, class... Args>
+    auto enqueue(TaskOptions options, F&& f, Args&&... args)
+        -> std::future<typename std::result_of<F(Args...)>::type>
+    {
+        using callableType = typename std::decay<F>::type;
+        static_assert(
+            utils::internal::is_invocable<callableType&, Args...>::value,
+            "ThreadPool task must be invocable with the supplied argument types");
+        using resultType = typename std::result_of<F(Args...)>::type;
+        return enqueueImpl<resultType>(options.priority, true,
+            std::bind(std::forward<F>(f), std::forward<Args>(args)...), &options);
     }
 
     template<class R, class Owner>
     auto enqueue(Owner* owner, R (Owner::*method)())
         -> std::future<R>
+    {
+        return enqueue(Priority::Normal, owner, method);
+    }
+
+    template<class R, class Owner>
+    auto enqueue(Priority priority, Owner* owner, R (Owner::*method)())
+        -> std::future<R>
     {
         static_assert(std::is_same<typename std::remove_reference<Owner>::type, Owner>::value,
                       "Owner type must not be a reference");
-        using taskType = std::packaged_task<R()>;
-        auto taskPtr = std::make_shared<taskType>([owner, method]() {
+        return enqueueImpl<R>(priority, true, [owner, method]() {
             return (owner->*method)();
         });
-
-        std::future<R> res = taskPtr->get_future();
-        std::unique_lock<std::mutex> lock(queueMtx_);
-        queueNotFullCv_.wait(lock, [this]{ return tasks_.size_approx() < maxQueueSize_ || !running_; });
-
-        if(!running_) return std::future<R>();
-
-        tasks_.enqueue(TaskCallback::template bindShared<taskType, &taskType::operator()>(taskPtr));
-        workerCv_.notify_one();
-
-        return res;
     }
 
     template<class R, class Owner>
     auto enqueue(const Owner* owner, R (Owner::*method)() const)
         -> std::future<R>
+    {
+        return enqueue(Priority::Normal, owner, method);
+    }
+
+    template<class R, class Owner>
+    auto enqueue(Priority priority, const Owner* owner, R (Owner::*method)() const)
+        -> std::future<R>
     {
         static_assert(std::is_same<typename std::remove_reference<Owner>::type, Owner>::value,
                       "Owner type must not be a reference");
-        using taskType = std::packaged_task<R()>;
-        auto taskPtr = std::make_shared<taskType>([owner, method]() {
+        return enqueueImpl<R>(priority, true, [owner, method]() {
             return (owner->*method)();
         });
-
-        std::future<R> res = taskPtr->get_future();
-        std::unique_lock<std::mutex> lock(queueMtx_);
-        queueNotFullCv_.wait(lock, [this]{ return tasks_.size_approx() < maxQueueSize_ || !running_; });
-
-        if(!running_) return std::future<R>();
-
-        tasks_.enqueue(TaskCallback::template bindShared<taskType, &taskType::operator()>(taskPtr));
-        workerCv_.notify_one();
-
-        return res;
     }
 
     /**
@@ -147,73 +274,71 @@ public:
     template<class F, class... Args>
     auto try_enqueue(F&& f, Args&&... args)
         -> std::future<typename std::result_of<F(Args...)>::type>
+    {
+        return try_enqueue(Priority::Normal, std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    template<class F, class... Args>
+    auto try_enqueue(Priority priority, F&& f, Args&&... args)
+        -> std::future<typename std::result_of<F(Args...)>::type>
     {
         using callableType = typename std::decay<F>::type;
         static_assert(
             utils::internal::is_invocable<callableType&, Args...>::value,
             "ThreadPool task must be invocable with the supplied argument types");
         using resultType = typename std::result_of<F(Args...)>::type;
-        using taskType = std::packaged_task<resultType()>;
-        auto taskPtr = std::make_shared<taskType>(
-            std::bind(std::forward<F>(f), std::forward<Args>(args)...)
-        );
-
-        std::future<resultType> res = taskPtr->get_future();
-        std::lock_guard<std::mutex> lock(queueMtx_);
-
-        if(tasks_.size_approx() >= maxQueueSize_ || !running_)
-            return std::future<resultType>(); // 队列满直接返回空 future
-
-        tasks_.enqueue(TaskCallback::template bindShared<taskType, &taskType::operator()>(taskPtr));
-        workerCv_.notify_one();
+        // 队列满直接返回空 future
+        return enqueueImpl<resultType>(priority, false,
+            std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+    }
 
-        return res;
+    template<class F, class... Args>
+    auto try_enqueue(TaskOptions options, F&& f, Args&&... args)
+        -> std::future<typename std::result_of<F(Args...)>::type>
+    {
+        using callableType = typename std::decay<F>::type;
+        static_assert(
+            utils::internal::is_invocable<callableType&, Args...>::value,
+            "ThreadPool task must be invocable with the supplied argument types");
+        using resultType = typename std::result_of<F(Args...)>::type;
+        return enqueueImpl<resultType>(options.priority, false,
+            std::bind(std::forward<F>(f), std::forward<Args>(args)...), &options);
     }
 
     template<class R, class Owner>
     auto try_enqueue(Owner* owner, R (Owner::*method)())
         -> std::future<R>
+    {
+        return try_enqueue(Priority::Normal, owner, method);
+    }
+
+    template<class R, class Owner>
+    auto try_enqueue(Priority priority, Owner* owner, R (Owner::*method)())
+        -> std::future<R>
     {
         static_assert(std::is_same<typename std::remove_reference<Owner>::type, Owner>::value,
                       "Owner type must not be a reference");
-        using taskType = std::packaged_task<R()>;
-        auto taskPtr = std::make_shared<taskType>([owner, method]() {
+        return enqueueImpl<R>(priority, false, [owner, method]() {
             return (owner->*method)();
         });
-
-        std::future<R> res = taskPtr->get_future();
-        std::lock_guard<std::mutex> lock(queueMtx_);
-
-        if(tasks_.size_approx() >= maxQueueSize_ || !running_)
-            return std::future<R>();
-
-        tasks_.enqueue(TaskCallback::template bindShared<taskType, &taskType::operator()>(taskPtr));
-        workerCv_.notify_one();
-
-        return res;
     }
 
     template<class R, class Owner>
     auto try_enqueue(const Owner* owner, R (Owner::*method)() const)
         -> std::future<R>
+    {
+        return try_enqueue(Priority::Normal, owner, method);
+    }
+
+    template<class R, class Owner>
+    auto try_enqueue(Priority priority, const Owner* owner, R (Owner::*method)() const)
+        -> std::future<R>
     {
         static_assert(std::is_same<typename std::remove_reference<Owner>::type, Owner>::value,
                       "Owner type must not be a reference");
-        using taskType = std::packaged_task<R()>;
-        auto taskPtr = std::make_shared<taskType>([owner, method]() {
+        return enqueueImpl<R>(priority, false, [owner, method]() {
             return (owner->*method)();
         });
-
-        std::future<R> res = taskPtr->get_future();
-        std::lock_guard<std::mutex> lock(queueMtx_);
-
-        if(tasks_.size_approx() >= maxQueueSize_ || !running_)
-            return std::future<R>();
-
-        tasks_.enqueue(TaskCallback::template bindShared<taskType, &taskType::operator()>(taskPtr));
-        workerCv_.notify_one();
-
-        return res;
     }
 
     /**
@@ -222,6 +347,12 @@ public:
      */
     template<class F, class... Args>
     bool post(F&& f, Args&&... args)
+    {
+        return post(Priority::Normal, std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    template<class F, class... Args>
+    bool post(Priority priority, F&& f, Args&&... args)
     {
         using callableType = typename std::decay<F>::type;
         static_assert(
@@ -229,55 +360,51 @@ public:
             "ThreadPool task must be invocable with the supplied argument types");
 
         auto bound = std::bind(std::forward<F>(f), std::forward<Args>(args)...);
-        auto taskWrapper = [bound = std::move(bound)]() mutable {
+        return postImpl(priority, true, [bound = std::move(bound)]() mutable {
             (void)bound();
-        };
-        using taskType = typename std::decay<decltype(taskWrapper)>::type;
-        auto taskPtr = std::make_shared<taskType>(std::move(taskWrapper));
+        });
+    }
 
-        std::unique_lock<std::mutex> lock(queueMtx_);
-        queueNotFullCv_.wait(lock, [this]{ return tasks_.size_approx() < maxQueueSize_ || !running_; });
-        if(!running_) return false;
+    template<class F, class... Args>
+    bool post(TaskOptions options, F&& f, Args&&... args)
+    {
+        using callableType = typename std::decay<F>::type;
+        static_assert(
+            utils::internal::is_invocable<callableType&, Args...>::value,
+            "ThreadPool task must be invocable with the supplied argument types");
 
-        tasks_.enqueue(TaskCallback::template bindShared<taskType, &taskType::operator()>(taskPtr));
-        workerCv_.notify_one();
-        return true;
+        auto bound = std::bind(std::forward<F>(f), std::forward<Args>(args)...);
+        return postImpl(options.priority, true, [bound = std::move(bound)]() mutable {
+            (void)bound();
+        }, &options);
     }
 
     template<class Owner>
     bool post(Owner* owner, void (Owner::*method)())
     {
-        auto taskWrapper = [owner, method]() mutable {
-            (owner->*method)();
-        };
-        using taskType = typename std::decay<decltype(taskWrapper)>::type;
-        auto taskPtr = std::make_shared<taskType>(std::move(taskWrapper));
-
-        std::unique_lock<std::mutex> lock(queueMtx_);
-        queueNotFullCv_.wait(lock, [this]{ return tasks_.size_approx() < maxQueueSize_ || !running_; });
-        if(!running_) return false;
-
-        tasks_.enqueue(TaskCallback::template bindShared<taskType, &taskType::operator()>(taskPtr));
-        workerCv_.notify_one();
-        return true;
+        return post(Priority::Normal, owner, method);
     }
 
     template<class Owner>
-    bool post(const Owner* owner, void (Owner::*method)() const)
+    bool post(Priority priority, Owner* owner, void (Owner::*method)())
     {
-        auto taskWrapper = [owner, method]() mutable {
+        return postImpl(priority, true, [owner, method]() mutable {
             (owner->*method)();
-        };
-        using taskType = typename std::decay<decltype(taskWrapper)>::type;
-        auto taskPtr = std::make_shared<taskType>(std::move(taskWrapper));
+        });
+    }
 
-        std::unique_lock<std::mutex> lock(queueMtx_);
-        queueNotFullCv_.wait(lock, [this]{ return tasks_.size_approx() < maxQueueSize_ || !running_; });
-        if(!running_) return false;
+    template<class Owner>
+    bool post(const Owner* owner, void (Owner::*method)() const)
+    {
+        return post(Priority::Normal, owner, method);
+    }
 
-        tasks_.enqueue(TaskCallback::template bindShared<taskType, &taskType::operator()>(taskPtr));
-        workerCv_.notify_one();
-        return true;
+    template<class Owner>
+    bool post(Priority priority, const Owner* owner, void (Owner::*method)() const)
+    {
+        return postImpl(priority, true, [owner, method]() mutable {
+            (owner->*method)();
+        });
     }
 
     /**
@@ -286,6 +413,12 @@ public:
      */
     template<class F, class... Args>
     bool try_post(F&& f, Args&&... args)
+    {
+        return try_post(Priority::Normal, std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    template<class F, class... Args>
+    bool try_post(Priority priority, F&& f, Args&&... args)
     {
         using callableType = typename std::decay<F>::type;
         static_assert(
@@ -293,54 +426,161 @@ public:
             "ThreadPool task must be invocable with the supplied argument types");
 
         auto bound = std::bind(std::forward<F>(f), std::forward<Args>(args)...);
-        auto taskWrapper = [bound = std::move(bound)]() mutable {
+        return postImpl(priority, false, [bound = std::move(bound)]() mutable {
             (void)bound();
-        };
-        using taskType = typename std::decay<decltype(taskWrapper)>::type;
-        auto taskPtr = std::make_shared<taskType>(std::move(taskWrapper));
+        });
+    }
 
-        std::lock_guard<std::mutex> lock(queueMtx_);
-        if(tasks_.size_approx() >= maxQueueSize_ || !running_) return false;
+    template<class F, class... Args>
+    bool try_post(TaskOptions options, F&& f, Args&&... args)
+    {
+        using callableType = typename std::decay<F>::type;
+        static_assert(
+            utils::internal::is_invocable<callableType&, Args...>::value,
+            "ThreadPool task must be invocable with the supplied argument types");
 
-        tasks_.enqueue(TaskCallback::template bindShared<taskType, &taskType::operator()>(taskPtr));
-        workerCv_.notify_one();
-        return true;
+        auto bound = std::bind(std::forward<F>(f), std::forward<Args>(args)...);
+        return postImpl(options.priority, false, [bound = std::move(bound)]() mutable {
+            (void)bound();
+        }, &options);
     }
 
     template<class Owner>
     bool try_post(Owner* owner, void (Owner::*method)())
     {
-        auto taskWrapper = [owner, method]() mutable {
-            (owner->*method)();
-        };
-        using taskType = typename std::decay<decltype(taskWrapper)>::type;
-        auto taskPtr = std::make_shared<taskType>(std::move(taskWrapper));
-
-        std::lock_guard<std::mutex> lock(queueMtx_);
-        if(tasks_.size_approx() >= maxQueueSize_ || !running_) return false;
+        return try_post(Priority::Normal, owner, method);
+    }
 
-        tasks_.enqueue(TaskCallback::template bindShared<taskType, &taskType::operator()>(taskPtr));
-        workerCv_.notify_one();
-        return true;
+    template<class Owner>
+    bool try_post(Priority priority, Owner* owner, void (Owner::*method)())
+    {
+        return postImpl(priority, false, [owner, method]() mutable {
+            (owner->*method)();
+        });
     }
 
     template<class Owner>
     bool try_post(const Owner* owner, void (Owner::*method)() const)
     {
-        auto taskWrapper = [owner, method]() mutable {
+        return try_post(Priority::Normal, owner, method);
+    }
+
+    template<class Owner>
+    bool try_post(Priority priority, const Owner* owner, void (Owner::*method)() const)
+    {
+        return postImpl(priority, false, [owner, method]() mutable {
             (owner->*method)();
-        };
-        using taskType = typename std::decay<decltype(taskWrapper)>::type;
-        auto taskPtr = std::make_shared<taskType>(std::move(taskWrapper));
+        });
+    }
 
-        std::lock_guard<std::mutex> lock(queueMtx_);
-        if(tasks_.size_approx() >= maxQueueSize_ || !running_) return false;
+    /**
+     * @brief 批量阻塞投递: 依次投递 f(0) ... f(count-1), 每批只做一次名额预留和一次唤醒
+     * 适合把一帧拆成 tile / 按 plane 分发的场景
+     * @return 实际投递的任务数(线程池停止时可能小于 count)
+     */
+    template<class F>
+    size_t post_bulk(size_t count, F&& f)
+    {
+        return post_bulk(Priority::Normal, count, std::forward<F>(f));
+    }
 
-        tasks_.enqueue(TaskCallback::template bindShared<taskType, &taskType::operator()>(taskPtr));
-        workerCv_.notify_one();
-        return true;
+    template<class F>
+    size_t post_bulk(Priority priority, size_t count, F&& f)
+    {
+        return postBulkImpl(priority, true, count, std::forward<F>(f));
     }
 
+    /**
+     * @brief 批量非阻塞投递, 队列放不下的部分直接放弃
+     * @return 实际投递的任务数
+     */
+    template<class F>
+    size_t try_post_bulk(size_t count, F&& f)
+    {
+        return try_post_bulk(Priority::Normal, count, std::forward<F>(f));
+    }
+
+    template<class F>
+    size_t try_post_bulk(Priority priority, size_t count, F&& f)
+    {
+        return postBulkImpl(priority, false, count, std::forward<F>(f));
+    }
+
+    /**
+     * @brief 批量阻塞入队 f(0) ... f(count-1), 返回与下标一一对应的 future
+     * 线程池停止时未投递部分的 future 为 invalid
+     */
+    template<class F>
+    auto enqueue_bulk(size_t count, F&& f)
+        -> std::vector<std::future<typename std::result_of<F(size_t)>::type>>
+    {
+        return enqueue_bulk(Priority::Normal, count, std::forward<F>(f));
+    }
+
+    template<class F>
+    auto enqueue_bulk(Priority priority, size_t count, F&& f)
+        -> std::vector<std::future<typename std::result_of<F(size_t)>::type>>
+    {
+        using callableType = typename std::decay<F>::type;
+        static_assert(
+            utils::internal::is_invocable<callableType&, size_t>::value,
+            "Bulk task must be invocable with a size_t index");
+        using resultType = typename std::result_of<F(size_t)>::type;
+
+        std::vector<std::future<resultType>> futures;
+        futures.reserve(count);
+        callableType fn(std::forward<F>(f));
+        submitBulk(priority, true, count, [&futures, &fn](TaskNode* node, size_t index) {
+            std::promise<resultType> promise(std::allocator_arg, utils::internal::PooledAllocator<char>());
+            futures.emplace_back(promise.get_future());
+            emplaceTask(node, PromiseTask<resultType, IndexedCall<callableType>>{
+                std::move(promise), IndexedCall<callableType>{fn, index}});
+        });
+        futures.resize(count);
+        return futures;
+    }
+
+    /**
+     * @brief 线程池运行统计(计数为累计值, 读取时无锁汇总)
+     */
+    struct PoolStats {
+        size_t aliveThreads;        // 当前工作线程数
+        size_t pendingTasks;        // 已入队未开始的任务数
+        size_t activeTasks;         // 正在执行的任务数
+        uint64_t executedTasks;     // 已执行任务数
+        uint64_t stolenTasks;       // 通过窃取获得的任务数
+        uint64_t parks;             // 工作线程进入休眠的次数
+        uint64_t bulkSubmits;       // post_bulk/enqueue_bulk 提交批次数
+        uint64_t bulkSubmittedTasks;// 批量提交的任务总数
+        uint64_t bulkDequeues;      // 工作线程批量出队次数
+        uint64_t bulkDequeuedTasks; // 批量出队的任务总数
+        uint64_t wakeRounds;        // 唤醒轮次(每轮一次加锁 + 若干 notify)
+        uint64_t wokenWorkers;      // 被 notify 的工作线程总数
+        uint64_t threadsAdded;      // manager 扩容新增的线程总数
+        uint64_t threadsRemoved;    // manager 缩容回收的线程总数
+        uint64_t expiredTasks;      // 出队时已过 deadline 被丢弃的任务数
+        uint64_t cancelledTasks;    // 出队时已取消被丢弃的任务数
+    };
+
+    PoolStats getPoolStats() const;
+
+    /**
+     * @brief 任务级统计(默认关闭): 入队到开始执行的等待时间, 执行时间, 入队时的队列深度
+     * 关闭时热路径只多一次 relaxed load; 开启后每个任务多两次时钟读取和三次直方图记录.
+     */
+    using HistogramSummary = utils::internal::LogLinearHistogram::Summary;
+
+    struct InstrumentationSnapshot {
+        HistogramSummary waitNs;    // 入队 -> 开始执行, 纳秒
+        HistogramSummary execNs;    // 执行耗时, 纳秒
+        HistogramSummary queueDepth;// 入队时已挂起的任务数
+    };
+
+    void setInstrumentation(bool enabled);
+    bool instrumentationEnabled() const;
+    InstrumentationSnapshot getInstrumentation() const;
+    void resetInstrumentation();
+
     /**
      * @brief 手动停止线程池
      */
@@ -354,28 +594,251 @@ public:
 private:
     // ----------------- 内部类型 -----------------
     struct WorkerWrapper; // 工作线程封装, 记录活跃时间与停止标志
+    struct WorkerSlot;    // 工作线程槽位, 持有本地工作窃取队列
+    struct Instrumentation; // 任务级直方图
+
+    // 调度单元, 队列中只传递节点指针.
+    // 节点来自进程级 SmallBlockPool, 小任务直接构造在内联存储中, 提交路径不触发堆分配;
+    // 超出内联容量的大捕获才回退为堆上的 TaskCallback.
+    // 节点保持 128 字节(两条 cache line), 内联存储按 8 字节对齐, 对齐要求更高的任务走回退路径.
+    struct TaskNode {
+        static constexpr std::size_t kInlineBytes = 88;
+        static constexpr std::size_t kInlineAlign = alignof(void*);
+        using InvokeFn = void (*)(TaskNode*);
+
+        InvokeFn run = nullptr;   // 执行并析构任务
+        InvokeFn drop = nullptr;  // 不执行, 仅析构任务(线程池停止/任务过期/取消时丢弃)
+        int64_t enqueueNs = 0;    // 入队时刻(steady_clock 纳秒), 仅开启统计时写入
+        int64_t deadlineNs = 0;   // 截止时刻(steady_clock 纳秒), 0 表示无截止时间
+        CancellationToken::State* cancel = nullptr; // 持有一个引用, releaseNode 时释放
+        alignas(kInlineAlign) unsigned char storage[kInlineBytes];
+    };
+
+    template<class T>
+    struct DestroyGuard {
+        T* obj;
+        ~DestroyGuard() { obj->~T(); }
+    };
+
+    // 批量任务体: 保存 f 的副本与下标, 调用时执行 f(index)
+    template<class F>
+    struct IndexedCall {
+        F fn;
+        size_t index;
+
+        auto operator()() -> decltype(fn(index)) { return fn(index); }
+    };
+
+    // enqueue 的任务体: 执行结果写入 promise, 替代 packaged_task + make_shared
+    template<class R, class F>
+    struct PromiseTask {
+        std::promise<R> promise;
+        F fn;
+
+        void operator()() { fulfill(std::is_void<R>()); }
+        void fulfill(std::false_type) {
+            try { promise.set_value(fn()); }
+            catch(...) { promise.set_exception(std::current_exception()); }
+        }
+        void fulfill(std::true_type) {
+            try { fn(); promise.set_value(); }
+            catch(...) { promise.set_exception(std::current_exception()); }
+        }
+    };
 
     // ----------------- 内部函数 -----------------
+    // future 只在 enqueue 时创建, promise 共享状态同样从 SmallBlockPool 分配
+    template<class R, class Callable>
+    std::future<R> enqueueImpl(Priority priority, bool block, Callable&& callable,
+                               const TaskOptions* options = nullptr)
+    {
+        TaskNode* node = acquireNode(priority, block);
+        if(!node) return std::future<R>();
+        if(options) applyOptions(node, *options);
+        try {
+            std::promise<R> promise(std::allocator_arg, utils::internal::PooledAllocator<char>());
+            std::future<R> res = promise.get_future();
+            emplaceTask(node, PromiseTask<R, typename std::decay<Callable>::type>{
+                std::move(promise), std::forward<Callable>(callable)});
+            dispatchNode(node, priority);
+            return res;
+        } catch(...) {
+            abandonNode(node);
+            throw;
+        }
+    }
+
+    template<class Callable>
+    bool postImpl(Priority priority, bool block, Callable&& callable, const TaskOptions* options = nullptr)
+    {
+        TaskNode* node = acquireNode(priority, block);
+        if(!node) return false;
+        if(options) applyOptions(node, *options);
+        try {
+            emplaceTask(node, std::forward<Callable>(callable));
+        } catch(...) {
+            abandonNode(node);
+            throw;
+        }
+        dispatchNode(node, priority);
+        return true;
+    }
+
+    template<class Callable>
+    static void emplaceTask(TaskNode* node, Callable&& callable)
+    {
+        using taskType = typename std::decay<Callable>::type;
+        using fitsInline = std::integral_constant<bool,
+            sizeof(taskType) <= TaskNode::kInlineBytes && alignof(taskType) <= TaskNode::kInlineAlign>;
+        emplaceTask<taskType>(node, std::forward<Callable>(callable), fitsInline());
+    }
+
+    template<class T, class Callable>
+    static void emplaceTask(TaskNode* node, Callable&& callable, std::true_type)
+    {
+        ::new (static_cast<void*>(node->storage)) T(std::forward<Callable>(callable));
+        node->run = [](TaskNode* n) {
+            T* fn = reinterpret_cast<T*>(n->storage);
+            DestroyGuard<T> guard{fn};
+            (*fn)();
+        };
+        node->drop = [](TaskNode* n) {
+            reinterpret_cast<T*>(n->storage)->~T();
+        };
+    }
+
+    template<class T, class Callable>
+    static void emplaceTask(TaskNode* node, Callable&& callable, std::false_type)
+    {
+        // 大捕获回退到堆上, 由 TaskCallback 持有
+        emplaceTask<TaskCallback>(node, TaskCallback(std::forward<Callable>(callable)), std::true_type());
+    }
+
+    template<class F>
+    size_t postBulkImpl(Priority priority, bool block, size_t count, F&& f)
+    {
+        using callableType = typename std::decay<F>::type;
+        static_assert(
+            utils::internal::is_invocable<callableType&, size_t>::value,
+            "Bulk task must be invocable with a size_t index");
+        callableType fn(std::forward<F>(f));
+        return submitBulk(priority, block, count, [&fn](TaskNode* node, size_t index) {
+            emplaceTask(node, [fn, index]() mutable { (void)fn(index); });
+        });
+    }
+
+    // 按批构造节点: 每批一次名额预留, 一次入队, 一次唤醒
+    template<class Emplacer>
+    size_t submitBulk(Priority priority, bool block, size_t count, Emplacer&& emplacer)
+    {
+        TaskNode* batch[kBulkBatchMax];
+        size_t done = 0;
+        while (done < count) {
+            // 不用 std::min: 按引用传参会 ODR 使用 kBulkBatchMax, C++14 下需要类外定义, -O0 时链接失败
+            const size_t left = count - done;
+            const size_t want = left < kBulkBatchMax ? left : kBulkBatchMax;
+            const size_t got = acquireQueueSlots(priority, want, block);
+            if (got == 0) break;
+
+            size_t built = 0;
+            try {
+                for (; built < got; ++built) {
+                    batch[built] = allocNode();
+                    try {
+                        emplacer(batch[built], done + built);
+                    } catch(...) {
+                        releaseNode(batch[built]);
+                        throw;
+                    }
+                }
+            } catch(...) {
+                for (size_t i = 0; i < built; ++i) {
+                    batch[i]->drop(batch[i]);
+                    releaseNode(batch[i]);
+                }
+                releaseQueueSlots(got);
+                throw;
+            }
+
+            dispatchNodes(batch, got, priority);
+            done += got;
+        }
+        return done;
+    }
+
+    static constexpr size_t kBulkBatchMax = 32;
+
+    TaskNode* acquireNode(Priority priority, bool block);     // 预留队列名额并从节点池取节点, 失败返回 nullptr
+    static TaskNode* allocNode();                             // 只从节点池取节点, 不预留名额
+    static void applyOptions(TaskNode* node, const TaskOptions& options); // 写入截止时间与取消令牌
+    size_t acquireQueueSlots(Priority priority, size_t want, bool block); // 批量预留, 返回实际预留数
+    void releaseQueueSlots(size_t count);
+    void dispatchNodes(TaskNode** nodes, size_t count, Priority priority); // 批量入队 + 一次唤醒
+    void dispatchNode(TaskNode* node, Priority priority);     // 入队: Normal 任务在工作线程内优先压本地队列
+    void abandonNode(TaskNode* node);                         // 构造任务失败时归还节点与名额
+    static void releaseNode(TaskNode* node);                  // 节点归还 SmallBlockPool
+    size_t admissionLimit(Priority priority) const;           // 各优先级可占用的队列名额上限
+    bool acquireQueueSlot(Priority priority, bool block);     // 按 maxQueueSize 预留名额
+    void releaseQueueSlot();                                  // 任务出队后归还名额
+    TaskNode* findTask(WorkerSlot& slot, uint32_t& rng, uint64_t tick); // 本地 -> 全局 -> 窃取
+    void wakeWorker();                                        // 有休眠线程时唤醒一个
+    void wakeWorkers(size_t count);                           // 一次加锁唤醒至多 count 个休眠线程
+    void stampNodes(TaskNode** nodes, size_t count);          // 开启统计时记录入队时刻与队列深度
+    void runNode(WorkerSlot& slot, TaskNode* node);           // 执行任务(过期/已取消则丢弃), 开启统计时记录耗时
+    void checkBacklog();                                      // 提交后检查 backlog 是否需要立即扩容
+    void requestScale();                                      // 唤醒 manager 立即执行一次 adjustThreads
+    void parkWorker(const WorkerWrapper& wrapper);            // 无任务时休眠
+    void applyPlacement(const WorkerSlot& slot);              // 工作线程启动时应用放置策略
     void worker(std::weak_ptr<WorkerWrapper> wrapper);      // 工作线程函数
     void managerThreadFunc();                                 // 管理线程函数
     void adjustThreads();                                     // 动态扩缩容逻辑
+    WorkerSlot* claimSlot();                                  // 为新线程分配空闲槽位(持有 workersMtx_)
+    void drainTasks();                                        // 丢弃所有未执行任务
 
     // ----------------- 数据成员 -----------------
     std::atomic<bool> running_;
     std::atomic<size_t> activeTasks_{0};                      // 当前活跃任务数
-
-    mutable std::mutex queueMtx_;
-    std::condition_variable workerCv_;
+    std::atomic<size_t> pendingTasks_{0};                     // 已入队未出队的任务数(含本地队列)
+
+    // 休眠/唤醒只在慢路径上加锁, 热路径只读 sleepers_ 计数
+    std::mutex parkMtx_;
+    std::condition_variable parkCv_;
+    std::atomic<size_t> sleepers_{0};
+    std::atomic<uint64_t> wakeRounds_{0};
+    std::atomic<uint64_t> wokenWorkers_{0};
+    std::atomic<uint64_t> bulkSubmits_{0};
+    std::atomic<uint64_t> bulkSubmittedTasks_{0};
+    std::atomic<uint64_t> threadsAdded_{0};
+    std::atomic<uint64_t> threadsRemoved_{0};
+
+    std::atomic<bool> instrumented_{false};
+    std::unique_ptr<Instrumentation> instr_;
+
+    // 队列满时阻塞生产者
+    std::mutex notFullMtx_;
     std::condition_variable queueNotFullCv_;
+    std::atomic<size_t> blockedProducers_{0};
 
-    moodycamel::ConcurrentQueue<TaskCallback> tasks_;                          // 任务队列
+    moodycamel::ConcurrentQueue<TaskNode*> injectQueues_[kPriorityCount]; // 按优先级划分的全局注入队列
+    std::vector<std::unique_ptr<WorkerSlot>> slots_;          // 固定 maxThreads_ 个槽位, 生命周期与线程池一致
     std::size_t maxQueueSize_;
 
+    ScalingPolicy policy_;
+    PlacementPolicy placement_;
     std::thread managerThread_;                               // 管理线程
+    std::mutex managerMtx_;
+    std::condition_variable managerCv_;
+    std::atomic<bool> scaleRequested_{false};                 // 已有待处理的扩容请求, 避免重复唤醒
+    std::atomic<size_t> liveWorkers_{0};                      // workers_.size() 的无锁副本
+    int64_t lowLoadSinceNs_ = 0;                              // 低负载开始时刻, 仅 manager 访问
+    mutable std::mutex workersMtx_;                           // 保护 workers_ 及槽位分配
     std::vector<std::shared_ptr<WorkerWrapper>> workers_;
 
     size_t minThreads_;
     size_t maxThreads_;
+
+    // 当前线程所属的槽位(仅工作线程非空), 用于判断是否可以压入本地队列
+    static thread_local WorkerSlot* currentSlot_;
 };
 
 #endif
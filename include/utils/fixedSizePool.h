@@ -2,11 +2,17 @@
 #include <atomic>
 #include <vector>
 #include <mutex>
+#include <chrono>
 #include <cstdlib>
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <algorithm>
 #include <memory>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 // 根据架构定义对齐大小和缓存参数
 #ifdef __arm__
@@ -28,131 +34,389 @@
     #define UNLIKELY(x) __builtin_expect(!!(x), 0)
 #endif
 
+/*
+ * 线程缓存按池实例区分:
+ *  - 每个池有进程内唯一且不复用的 id, 每个线程维护一张 {池 id -> ThreadCache} 小表;
+ *  - 快速路径只比较线程上次使用的池 id, 命中后与原先单一 TLS 缓存一样直接操作数组;
+ *  - 中心链表和页面放在 shared_ptr 管理的 Central 中, 线程缓存只持有 weak_ptr:
+ *    线程退出时池仍存活则归还缓存, 池已销毁则直接丢弃; 已销毁池的表项在下次查表未命中时清理.
+ *
+ * 内存归还:
+ *  - 页面直接 mmap/munmap(对齐要求超过系统页时回退 posix_memalign), 释放后 RSS 立即下降,
+ *    不受 malloc 动态 mmap 阈值影响;
+ *  - trim() 统计中心空闲链表在各页上的块数, 整页空闲的页归还系统. 仍有块在使用者手里
+ *    或躺在其他线程缓存里的页不会被释放;
+ *  - 可选自动 trim: 块回到中心链表时(线程缓存回冲/线程退出)检查使用率, 低于水位线则顺带 trim.
+ */
 class FixedSizePool {
 public:
     struct Node { Node* next; };
 
-    // 关键优化: alignas(64) 确保每个线程的缓存独占缓存行, 防止伪共享
-    struct alignas(ARCH_LINE_SIZE) ThreadCache {
+    // 每个线程每个池一份, 独立堆分配(约 16KB), 不同线程的缓存不会落在同一缓存行.
+    // count 只由所属线程写, 原子变量仅用于统计时跨线程读取(relaxed, 不引入额外指令)
+    struct ThreadCache {
+        std::atomic<size_t> count{0};
         void* blocks[TLS_CACHE_SIZE];
-        size_t count = 0;
-        FixedSizePool* owner = nullptr;
+    };
 
-        // 线程退出时自动回收内存到全局链表
-        ~ThreadCache() {
-            if (owner && count > 0) owner->flush_all(this);
-        }
+    // 自动 trim 策略
+    struct TrimPolicy {
+        bool auto_trim = false;
+        double low_watermark = 0.25;        // 使用中的块 / 总块数 低于该值时触发
+        size_t keep_pages = 1;              // 保留的整页空闲页数, 吸收下一次突发
+        std::chrono::milliseconds min_interval{1000}; // 两次自动 trim 的最小间隔
+    };
+
+    struct Stats {
+        size_t block_size = 0;
+        size_t pages = 0;
+        size_t total_blocks = 0;
+        size_t live_blocks = 0;             // 使用者持有的块
+        size_t central_free = 0;            // 中心空闲链表长度
+        size_t cached_blocks = 0;           // 所有线程缓存合计
+        std::vector<size_t> cached_per_thread;
+        size_t trimmed_pages = 0;           // 累计归还系统的页数
     };
 
     FixedSizePool(size_t blockSize, size_t blocksPerPage = 2048, size_t alignment = 64, size_t prealloc = 0)
-        : alignment_(alignment), blocksPerPage_(blocksPerPage) {
+        : id_(next_pool_id()), central_(std::make_shared<Central>()),
+          blocksPerPage_(blocksPerPage), alignment_(alignment) {
         size_t minSize = sizeof(Node*);
         // 确保 blockSize 对齐
         blockSize_ = (std::max(blockSize, minSize) + alignment - 1) & ~(alignment - 1);
+        central_->blocks_per_page = blocksPerPage_;
         if (prealloc > 0) expand(prealloc);
     }
 
-    ~FixedSizePool() {
-        std::lock_guard<std::mutex> lock(page_mutex_);
-        for (auto& page : pages_) {
-#ifdef _WIN32
-            _aligned_free(page.first);
-#else
-            free(page.first);
-#endif
-        }
-    }
+    FixedSizePool(const FixedSizePool&) = delete;
+    FixedSizePool& operator=(const FixedSizePool&) = delete;
+
+    // 页面随 Central 释放; 正在退出的线程若还在归还缓存, 会延后到归还结束
+    ~FixedSizePool() = default;
 
     // 分配入口: 极其精简, 适合 inline 展开
     void* allocate() {
         ThreadCache* cache = get_fast_thread_cache();
-        if (UNLIKELY(cache->count == 0)) {
+        size_t count = cache->count.load(std::memory_order_relaxed);
+        if (UNLIKELY(count == 0)) {
             refill(cache);
-            if (UNLIKELY(cache->count == 0)) return nullptr;
+            count = cache->count.load(std::memory_order_relaxed);
+            if (UNLIKELY(count == 0)) return nullptr;
         }
-        return cache->blocks[--cache->count];
+        cache->count.store(count - 1, std::memory_order_relaxed);
+        return cache->blocks[count - 1];
     }
 
     // 释放入口
     void deallocate(void* p) {
         if (UNLIKELY(!p)) return;
         ThreadCache* cache = get_fast_thread_cache();
-        if (UNLIKELY(cache->count >= TLS_CACHE_SIZE)) {
+        if (UNLIKELY(cache->count.load(std::memory_order_relaxed) >= TLS_CACHE_SIZE)) {
             flush(cache);
         }
-        cache->blocks[cache->count++] = p;
+        const size_t count = cache->count.load(std::memory_order_relaxed);
+        cache->blocks[count] = p;
+        cache->count.store(count + 1, std::memory_order_relaxed);
+    }
+
+    size_t block_size() const { return blockSize_; }
+
+    /*
+     * trim - 把整页空闲的页归还系统
+     * 调用线程在本池的缓存先全部归还中心链表; 其他线程缓存中的块所在页不会被释放.
+     * keep_pages: 保留的整页空闲页数
+     * 返回释放的页数
+     */
+    size_t trim(size_t keep_pages = 0) {
+        ThreadCache* cache = get_fast_thread_cache();
+        std::lock_guard<std::mutex> lock(central_->mutex);
+        central_->push_locked(cache);
+        return central_->trim_locked(keep_pages);
+    }
+
+    void set_trim_policy(const TrimPolicy& policy) {
+        std::lock_guard<std::mutex> lock(central_->mutex);
+        central_->trim_policy = policy;
+    }
+
+    Stats get_stats() const {
+        Stats stats;
+        std::lock_guard<std::mutex> lock(central_->mutex);
+        stats.block_size = blockSize_;
+        stats.pages = central_->pages.size();
+        stats.total_blocks = stats.pages * blocksPerPage_;
+        stats.central_free = central_->free_count;
+        stats.cached_per_thread.reserve(central_->caches.size());
+        for (const ThreadCache* cache : central_->caches) {
+            const size_t count = cache->count.load(std::memory_order_relaxed);
+            stats.cached_per_thread.push_back(count);
+            stats.cached_blocks += count;
+        }
+        stats.live_blocks = central_->live_locked();
+        stats.trimmed_pages = central_->trimmed_pages;
+        return stats;
     }
 
 private:
-    // 核心优化: 彻底移除 unordered_map, 使用真正的 TLS
+    struct Page {
+        char* addr;
+        size_t size;
+        bool mapped;   // true: mmap 分配; false: posix_memalign/_aligned_malloc
+    };
+
+    // 中心空闲链表与页面, 以下成员都由 mutex 保护
+    struct Central {
+        std::mutex mutex;
+        Node* freelist_head = nullptr;
+        size_t free_count = 0;
+        size_t blocks_per_page = 0;
+        std::vector<Page> pages;              // 按地址升序, trim 时二分定位块所在页
+        std::vector<ThreadCache*> caches;     // 已登记的线程缓存, 供统计和水位判断
+        size_t trimmed_pages = 0;
+        TrimPolicy trim_policy;
+        std::chrono::steady_clock::time_point last_auto_trim{};
+
+        ~Central() {
+            for (auto& page : pages) release_page(page);
+        }
+
+        size_t live_locked() const {
+            size_t cached = 0;
+            for (const ThreadCache* cache : caches) cached += cache->count.load(std::memory_order_relaxed);
+            const size_t idle = free_count + cached;
+            const size_t total = pages.size() * blocks_per_page;
+            return total > idle ? total - idle : 0;
+        }
+
+        // 把链表 [head, tail] 挂到中心空闲链表
+        void push_chain_locked(Node* head, Node* tail, size_t n) {
+            tail->next = freelist_head;
+            freelist_head = head;
+            free_count += n;
+        }
+
+        // 线程缓存全部归还中心链表
+        void push_locked(ThreadCache* cache) {
+            const size_t count = cache->count.load(std::memory_order_relaxed);
+            if (count == 0) return;
+            Node* local_head = nullptr;
+            Node* local_tail = nullptr;
+            for (size_t i = count; i > 0; --i) {
+                Node* node = (Node*)cache->blocks[i - 1];
+                node->next = local_head;
+                local_head = node;
+                if (!local_tail) local_tail = node;
+            }
+            cache->count.store(0, std::memory_order_relaxed);
+            push_chain_locked(local_head, local_tail, count);
+        }
+
+        size_t page_index(const void* p) const {
+            auto it = std::upper_bound(pages.begin(), pages.end(), (const char*)p,
+                                       [](const char* addr, const Page& page) { return addr < page.addr; });
+            return static_cast<size_t>(it - pages.begin()) - 1;
+        }
+
+        // 统计每页在中心链表中的空闲块数, 释放整页空闲的页(保留 keep_pages 个)
+        size_t trim_locked(size_t keep_pages) {
+            if (pages.empty() || free_count < blocks_per_page) return 0;
+
+            std::vector<size_t> free_in_page(pages.size(), 0);
+            for (Node* node = freelist_head; node; node = node->next) ++free_in_page[page_index(node)];
+
+            std::vector<char> release(pages.size(), 0);
+            size_t kept = 0, releasing = 0;
+            for (size_t i = 0; i < pages.size(); ++i) {
+                if (free_in_page[i] != blocks_per_page) continue;
+                if (kept < keep_pages) {
+                    ++kept;
+                } else {
+                    release[i] = 1;
+                    ++releasing;
+                }
+            }
+            if (releasing == 0) return 0;
+
+            // 从空闲链表中摘掉待释放页的块, 其余块保持原顺序
+            Node** link = &freelist_head;
+            for (Node* node = freelist_head; node;) {
+                Node* next = node->next;
+                if (release[page_index(node)]) {
+                    --free_count;
+                } else {
+                    *link = node;
+                    link = &node->next;
+                }
+                node = next;
+            }
+            *link = nullptr;
+
+            size_t out = 0;
+            for (size_t i = 0; i < pages.size(); ++i) {
+                if (release[i]) {
+                    release_page(pages[i]);
+                } else {
+                    pages[out++] = pages[i];
+                }
+            }
+            pages.resize(out);
+            trimmed_pages += releasing;
+            return releasing;
+        }
+
+        // 块回到中心链表后调用: 开启自动 trim 且使用率低于水位线时顺带 trim
+        void maybe_auto_trim_locked() {
+            if (LIKELY(!trim_policy.auto_trim) || pages.size() <= trim_policy.keep_pages) return;
+            const size_t total = pages.size() * blocks_per_page;
+            if (live_locked() > trim_policy.low_watermark * total) return;
+            const auto now = std::chrono::steady_clock::now();
+            if (now - last_auto_trim < trim_policy.min_interval) return;
+            last_auto_trim = now;
+            trim_locked(trim_policy.keep_pages);
+        }
+    };
+
+    struct CacheEntry {
+        uint64_t pool_id;
+        std::weak_ptr<Central> central;
+        std::unique_ptr<ThreadCache> cache;
+    };
+
+    // 线程持有的全部池缓存
+    struct ThreadCaches {
+        uint64_t last_id = 0;          // 上次使用的池 id, 0 表示无
+        ThreadCache* last = nullptr;
+        std::vector<CacheEntry> entries;
+
+        // 线程退出时自动回收内存到仍存活的池
+        ~ThreadCaches() {
+            for (auto& entry : entries) {
+                std::shared_ptr<Central> central = entry.central.lock();
+                if (!central) continue;
+                std::lock_guard<std::mutex> lock(central->mutex);
+                central->push_locked(entry.cache.get());
+                auto& caches = central->caches;
+                caches.erase(std::remove(caches.begin(), caches.end(), entry.cache.get()), caches.end());
+                central->maybe_auto_trim_locked();
+            }
+        }
+    };
+
+    static uint64_t next_pool_id() {
+        static std::atomic<uint64_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    static ThreadCaches& thread_caches() {
+        static thread_local ThreadCaches caches;
+        return caches;
+    }
+
+    // 快速路径: 同一线程连续使用同一个池时只有一次比较
     ThreadCache* get_fast_thread_cache() {
-        static thread_local ThreadCache cache;
-        if (UNLIKELY(cache.owner == nullptr)) {
-            cache.owner = this;
+        ThreadCaches& caches = thread_caches();
+        if (LIKELY(caches.last_id == id_)) return caches.last;
+        return lookup_thread_cache(caches);
+    }
+
+    ThreadCache* lookup_thread_cache(ThreadCaches& caches) {
+        ThreadCache* found = nullptr;
+        for (auto& entry : caches.entries) {
+            if (entry.pool_id == id_) {
+                found = entry.cache.get();
+                break;
+            }
+        }
+        if (!found) {
+            // 顺便清理已销毁池留下的表项(其中的块随页面一起释放了, 直接丢弃)
+            caches.entries.erase(
+                std::remove_if(caches.entries.begin(), caches.entries.end(),
+                               [](const CacheEntry& entry) { return entry.central.expired(); }),
+                caches.entries.end());
+            std::unique_ptr<ThreadCache> cache(new ThreadCache());
+            found = cache.get();
+            {
+                std::lock_guard<std::mutex> lock(central_->mutex);
+                central_->caches.push_back(found);
+            }
+            caches.entries.push_back(CacheEntry{id_, central_, std::move(cache)});
         }
-        return &cache;
+        caches.last_id = id_;
+        caches.last = found;
+        return found;
     }
 
     void refill(ThreadCache* cache) {
-        std::lock_guard<std::mutex> lock(central_mutex_);
-        if (UNLIKELY(!freelist_head_)) expand_internal();
+        std::lock_guard<std::mutex> lock(central_->mutex);
+        if (UNLIKELY(!central_->freelist_head)) expand_internal();
 
         // 尽量填满或拿走一个 Batch
-        size_t take = std::min((size_t)TLS_BATCH_SIZE, (size_t)TLS_CACHE_SIZE - cache->count);
-        for (size_t i = 0; i < take && freelist_head_; ++i) {
-            Node* node = freelist_head_;
-            freelist_head_ = node->next;
-            cache->blocks[cache->count++] = node;
+        size_t count = cache->count.load(std::memory_order_relaxed);
+        size_t take = std::min((size_t)TLS_BATCH_SIZE, (size_t)TLS_CACHE_SIZE - count);
+        for (size_t i = 0; i < take && central_->freelist_head; ++i) {
+            Node* node = central_->freelist_head;
+            central_->freelist_head = node->next;
+            cache->blocks[count++] = node;
+            --central_->free_count;
         }
+        cache->count.store(count, std::memory_order_relaxed);
     }
 
     void flush(ThreadCache* cache) {
         // 策略: 回冲一半缓存到全局, 保留一半在本地继续使用
-        size_t to_flush = TLS_BATCH_SIZE; 
+        size_t to_flush = TLS_BATCH_SIZE;
+        size_t count = cache->count.load(std::memory_order_relaxed);
         Node* local_head = nullptr;
         Node* local_tail = nullptr;
 
         // 优化: 在锁外构造链表结构, 减少锁持有时间
         for (size_t i = 0; i < to_flush; ++i) {
-            Node* node = (Node*)cache->blocks[--cache->count];
+            Node* node = (Node*)cache->blocks[--count];
             node->next = local_head;
             local_head = node;
             if (!local_tail) local_tail = node;
         }
+        cache->count.store(count, std::memory_order_relaxed);
 
-        std::lock_guard<std::mutex> lock(central_mutex_);
-        local_tail->next = freelist_head_;
-        freelist_head_ = local_head;
-    }
-
-    void flush_all(ThreadCache* cache) {
-        if (cache->count == 0) return;
-        Node* local_head = nullptr;
-        Node* local_tail = nullptr;
-        size_t temp_count = cache->count;
-        for (size_t i = 0; i < temp_count; ++i) {
-            Node* node = (Node*)cache->blocks[--cache->count];
-            node->next = local_head;
-            local_head = node;
-            if (!local_tail) local_tail = node;
-        }
-        std::lock_guard<std::mutex> lock(central_mutex_);
-        local_tail->next = freelist_head_;
-        freelist_head_ = local_head;
+        std::lock_guard<std::mutex> lock(central_->mutex);
+        central_->push_chain_locked(local_head, local_tail, to_flush);
+        central_->maybe_auto_trim_locked();
     }
 
     void expand(size_t pages) {
-        std::lock_guard<std::mutex> lock(expand_mutex_);
+        std::lock_guard<std::mutex> lock(central_->mutex);
         for (size_t i = 0; i < pages; ++i) expand_internal();
     }
 
+    static void release_page(const Page& page) {
+#ifdef _WIN32
+        _aligned_free(page.addr);
+#else
+        if (page.mapped) {
+            munmap(page.addr, page.size);
+        } else {
+            free(page.addr);
+        }
+#endif
+    }
+
+    // 调用方持有 central_->mutex
     void expand_internal() {
         size_t size = blockSize_ * blocksPerPage_;
         void* page = nullptr;
+        bool mapped = false;
 #ifdef _WIN32
         page = _aligned_malloc(size, alignment_);
+        if (!page) return;
 #else
-        if (posix_memalign(&page, alignment_, size) != 0) return;
+        static const size_t kSysPageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        if (alignment_ <= kSysPageSize) {
+            page = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (page == MAP_FAILED) return;
+            mapped = true;
+        } else if (posix_memalign(&page, alignment_, size) != 0) {
+            return;
+        }
 #endif
         // 初始化新页面并链接成单向链表
         Node* local_head = nullptr;
@@ -164,17 +428,16 @@ private:
 
         // 挂载到全局空闲链表头部
         Node* last_node = (Node*)((char*)page + (blocksPerPage_ - 1) * blockSize_);
-        last_node->next = freelist_head_;
-        freelist_head_ = (Node*)page;
+        central_->push_chain_locked(local_head, last_node, blocksPerPage_);
 
-        std::lock_guard<std::mutex> lock(page_mutex_);
-        pages_.emplace_back(page, size);
+        Page record{(char*)page, size, mapped};
+        auto& pages = central_->pages;
+        pages.insert(std::upper_bound(pages.begin(), pages.end(), record,
+                                      [](const Page& a, const Page& b) { return a.addr < b.addr; }),
+                     record);
     }
 
-    Node* freelist_head_ = nullptr;
-    std::mutex central_mutex_;
-    std::mutex page_mutex_;
-    std::mutex expand_mutex_;
+    const uint64_t id_;
+    std::shared_ptr<Central> central_;
     size_t blockSize_, blocksPerPage_, alignment_;
-    std::vector<std::pair<void*, size_t>> pages_;
-};
\ No newline at end of file
+};
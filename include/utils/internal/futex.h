@@ -0,0 +1,52 @@
+#ifndef UTILS_INTERNAL_FUTEX_H
+#define UTILS_INTERNAL_FUTEX_H
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace utils {
+namespace internal {
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "futex requires std::atomic<uint32_t> to be a plain 32-bit word");
+
+// 自旋等待时的 CPU 提示, 降低功耗并让出超线程资源
+inline void cpuRelax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// word 仍等于 expected 时休眠, timeout 为空表示无限等待.
+// 返回 false 表示超时; 被唤醒/值已改变/信号中断都返回 true, 调用方需自行复查条件.
+inline bool futexWait(std::atomic<uint32_t>& word, uint32_t expected,
+                      const std::chrono::nanoseconds* timeout = nullptr) noexcept {
+    timespec ts{};
+    timespec* tsp = nullptr;
+    if (timeout) {
+        const int64_t ns = timeout->count() > 0 ? timeout->count() : 0;
+        ts.tv_sec = static_cast<time_t>(ns / 1000000000);
+        ts.tv_nsec = static_cast<long>(ns % 1000000000);
+        tsp = &ts;
+    }
+    const long rc = syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE,
+                            expected, tsp, nullptr, 0);
+    return !(rc == -1 && errno == ETIMEDOUT);
+}
+
+inline void futexWake(std::atomic<uint32_t>& word, int count) noexcept {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+}
+
+} // namespace internal
+} // namespace utils
+
+#endif // UTILS_INTERNAL_FUTEX_H
@@ -0,0 +1,108 @@
+#ifndef UTILS_INTERNAL_LOG_LINEAR_HISTOGRAM_H
+#define UTILS_INTERNAL_LOG_LINEAR_HISTOGRAM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace utils {
+namespace internal {
+
+// 无锁 log-linear 直方图(HdrHistogram 的简化版).
+// 1. 每个 2 的幂区间再线性切成 8 个子桶, 相对误差不超过 12.5%, 小于 16 的值精确记录;
+// 2. record 只有一次 relaxed fetch_add(外加 max 的 CAS), 可在工作线程热路径上使用;
+// 3. snapshot 遍历所有桶求分位数, 只在读取统计时调用.
+// 分位数返回所在桶的上界, max 为精确值.
+class LogLinearHistogram {
+public:
+    static constexpr unsigned kSubBucketBits = 3;
+    static constexpr std::size_t kSubBuckets = std::size_t(1) << kSubBucketBits;
+    static constexpr std::size_t kBucketCount = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+    struct Summary {
+        uint64_t count;
+        uint64_t p50;
+        uint64_t p90;
+        uint64_t p99;
+        uint64_t max;
+    };
+
+    LogLinearHistogram() noexcept { reset(); }
+
+    LogLinearHistogram(const LogLinearHistogram&) = delete;
+    LogLinearHistogram& operator=(const LogLinearHistogram&) = delete;
+
+    void record(uint64_t value) noexcept {
+        buckets_[indexOf(value)].fetch_add(1, std::memory_order_relaxed);
+        uint64_t cur = max_.load(std::memory_order_relaxed);
+        while (value > cur &&
+               !max_.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    void reset() noexcept {
+        for (auto& b : buckets_) b.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    Summary snapshot() const noexcept {
+        uint64_t counts[kBucketCount];
+        uint64_t total = 0;
+        for (std::size_t i = 0; i < kBucketCount; ++i) {
+            counts[i] = buckets_[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+
+        Summary s{};
+        s.count = total;
+        s.max = max_.load(std::memory_order_relaxed);
+        if (total == 0) return s;
+
+        s.p50 = percentile(counts, total, 50);
+        s.p90 = percentile(counts, total, 90);
+        s.p99 = percentile(counts, total, 99);
+        // 桶上界可能超过真实最大值
+        if (s.p50 > s.max) s.p50 = s.max;
+        if (s.p90 > s.max) s.p90 = s.max;
+        if (s.p99 > s.max) s.p99 = s.max;
+        return s;
+    }
+
+    static std::size_t indexOf(uint64_t value) noexcept {
+        if (value < 2 * kSubBuckets) return static_cast<std::size_t>(value);
+        const unsigned msb = 63u - static_cast<unsigned>(__builtin_clzll(value));
+        const unsigned shift = msb - kSubBucketBits;
+        const std::size_t sub = static_cast<std::size_t>((value >> shift) & (kSubBuckets - 1));
+        return (msb - kSubBucketBits + 1) * kSubBuckets + sub;
+    }
+
+    // 桶内最大值
+    static uint64_t upperBoundOf(std::size_t index) noexcept {
+        if (index < 2 * kSubBuckets) return index;
+        const std::size_t group = index / kSubBuckets;
+        const std::size_t sub = index % kSubBuckets;
+        const unsigned shift = static_cast<unsigned>(group - 1);
+        const uint64_t low = static_cast<uint64_t>(kSubBuckets + sub) << shift;
+        return low + ((uint64_t(1) << shift) - 1);
+    }
+
+private:
+    static uint64_t percentile(const uint64_t* counts, uint64_t total, unsigned pct) noexcept {
+        // 向上取整的目标序号, 保证 p99 在样本少时也落在最大的那部分
+        const uint64_t rank = (total * pct + 99) / 100;
+        uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBucketCount; ++i) {
+            seen += counts[i];
+            if (seen >= rank && counts[i] > 0) return upperBoundOf(i);
+        }
+        return upperBoundOf(kBucketCount - 1);
+    }
+
+    std::atomic<uint64_t> buckets_[kBucketCount];
+    std::atomic<uint64_t> max_;
+};
+
+} // namespace internal
+} // namespace utils
+
+#endif // UTILS_INTERNAL_LOG_LINEAR_HISTOGRAM_H
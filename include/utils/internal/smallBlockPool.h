@@ -0,0 +1,60 @@
+#ifndef UTILS_INTERNAL_SMALL_BLOCK_POOL_H
+#define UTILS_INTERNAL_SMALL_BLOCK_POOL_H
+
+#include <cstddef>
+#include <new>
+
+namespace utils {
+namespace internal {
+
+// 进程级小块内存池, 服务线程池任务节点和 promise 共享状态这类"高频, 短命, 尺寸固定"的对象.
+// 1. 按 64 字节档位划分, 同一档位的块在所有线程池之间可以互换, 因此线程缓存无需区分池实例;
+// 2. 每线程缓存一条单链表, 分配/释放不加锁; 缓存过多或耗尽时与中心链表批量交换;
+// 3. 超过最大档位或对齐要求更高的请求直接回退到 operator new.
+// 中心链表中的块不归还系统, 生命周期与进程一致.
+class SmallBlockPool {
+public:
+    static constexpr std::size_t kGranularity = 64;
+    static constexpr std::size_t kClassCount = 4;
+    static constexpr std::size_t kMaxBytes = kGranularity * kClassCount;
+
+    static void* allocate(std::size_t bytes);
+    static void deallocate(void* p, std::size_t bytes) noexcept;
+};
+
+// 把 SmallBlockPool 接到标准库分配器接口上, 用于 std::promise(std::allocator_arg, ...) 等场景.
+template <typename T>
+struct PooledAllocator {
+    using value_type = T;
+
+    PooledAllocator() noexcept = default;
+    template <typename U>
+    PooledAllocator(const PooledAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        const std::size_t bytes = n * sizeof(T);
+        if (alignof(T) <= SmallBlockPool::kGranularity && bytes <= SmallBlockPool::kMaxBytes) {
+            return static_cast<T*>(SmallBlockPool::allocate(bytes));
+        }
+        return static_cast<T*>(::operator new(bytes));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        const std::size_t bytes = n * sizeof(T);
+        if (alignof(T) <= SmallBlockPool::kGranularity && bytes <= SmallBlockPool::kMaxBytes) {
+            SmallBlockPool::deallocate(p, bytes);
+            return;
+        }
+        ::operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const PooledAllocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const PooledAllocator<U>&) const noexcept { return false; }
+};
+
+} // namespace internal
+} // namespace utils
+
+#endif // UTILS_INTERNAL_SMALL_BLOCK_POOL_H
@@ -1,7 +1,10 @@
 #ifndef UTILS_INTERNAL_STATIC_CALLBACK_H
 #define UTILS_INTERNAL_STATIC_CALLBACK_H
 
+#include <cstddef>
+#include <cstring>
 #include <memory>
+#include <new>
 #include <type_traits>
 #include <utility>
 
@@ -14,15 +17,53 @@ template <typename Signature>
 class StaticCallback;
 
 // 这是一个"轻量,热点友好"的回调槽:
-// 1. 对普通 lambda / 函数对象:只在绑定时做一次模板实例化和可选堆分配;
+// 1. 对普通 lambda / 函数对象:只在绑定时做一次模板实例化;
+//    不超过 4 个指针大小, 可平凡复制/析构且能以 const 调用的 callable(如 [this, index] 这类捕获)
+//    直接放在内联缓冲区, 其余(更大/捕获 shared_ptr/mutable lambda)回退到堆上共享持有;
 // 2. 对成员函数:保存对象指针 + 编译期确定的 thunk,调用路径不再经过 std::function.
+// 拷贝语义: 拷贝出的回调与原回调共享同一份 callable 状态(与 shared_ptr 相同, 不同于 std::function).
+//    堆上的 callable 通过 holder_ 共享; 内联的只接受 const 调用, 调用不会改写状态,
+//    按字节复制与共享无法区分. 因此 mutable lambda 的计数等状态在所有拷贝间可见.
 // 目标不是完全复刻 std::function,而是覆盖当前热点所需的可调用场景.
 template <typename R, typename... Args>
 class StaticCallback<R(Args...)> {
 public:
+    static constexpr std::size_t kInlineSize = 4 * sizeof(void*);
+
     StaticCallback() noexcept = default;
     StaticCallback(std::nullptr_t) noexcept {}
 
+    // 内联 callable 可平凡复制且状态只读, 拷贝/移动时按字节复制后把 context_ 重新指向自己的缓冲区
+    StaticCallback(const StaticCallback& other) noexcept
+        : holder_(other.holder_), invoke_(other.invoke_) {
+        copyContextFrom(other);
+    }
+
+    StaticCallback(StaticCallback&& other) noexcept
+        : holder_(std::move(other.holder_)), invoke_(other.invoke_) {
+        copyContextFrom(other);
+        other.reset();
+    }
+
+    StaticCallback& operator=(const StaticCallback& other) noexcept {
+        if (this != &other) {
+            holder_ = other.holder_;
+            invoke_ = other.invoke_;
+            copyContextFrom(other);
+        }
+        return *this;
+    }
+
+    StaticCallback& operator=(StaticCallback&& other) noexcept {
+        if (this != &other) {
+            holder_ = std::move(other.holder_);
+            invoke_ = other.invoke_;
+            copyContextFrom(other);
+            other.reset();
+        }
+        return *this;
+    }
+
     template <
         typename Callable,
         typename Decayed = typename std::decay<Callable>::type,
@@ -45,11 +86,8 @@ public:
             is_exact_invocable_r<R, Decayed&, Args...>::value,
             "Callback return type must exactly match the configured signature");
 
-        auto holder = std::make_shared<Decayed>(std::forward<Callable>(callable));
-        holder_ = holder;
-        context_ = holder.get();
         // invoke_ 是一个普通函数指针,后续热路径调用只需要一次间接跳转.
-        invoke_ = &invokeCallable<Decayed>;
+        bindCallable<Decayed>(std::forward<Callable>(callable), FitsInline<Decayed>());
     }
 
     // 成员函数绑定路径不需要额外分配 callable 对象.
@@ -108,11 +146,54 @@ public:
 private:
     using InvokeFn = R (*)(void*, Args...);
 
+    template <typename Callable>
+    using FitsInline = std::integral_constant<bool,
+        sizeof(Callable) <= kInlineSize &&
+        alignof(Callable) <= alignof(void*) &&
+        std::is_trivially_copyable<Callable>::value &&
+        std::is_trivially_destructible<Callable>::value &&
+        is_exact_invocable_r<R, const Callable&, Args...>::value>;
+
+    template <typename Decayed, typename Callable>
+    void bindCallable(Callable&& callable, std::true_type) {
+        holder_.reset();
+        ::new (static_cast<void*>(storage_)) Decayed(std::forward<Callable>(callable));
+        context_ = storage_;
+        invoke_ = &invokeConstCallable<Decayed>;
+    }
+
+    template <typename Decayed, typename Callable>
+    void bindCallable(Callable&& callable, std::false_type) {
+        auto holder = std::make_shared<Decayed>(std::forward<Callable>(callable));
+        holder_ = holder;
+        context_ = holder.get();
+        invoke_ = &invokeCallable<Decayed>;
+    }
+
+    bool isInline() const noexcept {
+        return context_ == static_cast<const void*>(storage_);
+    }
+
+    void copyContextFrom(const StaticCallback& other) noexcept {
+        if (other.isInline()) {
+            std::memcpy(storage_, other.storage_, kInlineSize);
+            context_ = storage_;
+        } else {
+            context_ = other.context_;
+        }
+    }
+
     template <typename Callable>
     static R invokeCallable(void* context, Args... args) {
         return (*static_cast<Callable*>(context))(std::forward<Args>(args)...);
     }
 
+    // 内联 callable 只以 const 调用, 拷贝之间不会出现各自演化的状态
+    template <typename Callable>
+    static R invokeConstCallable(void* context, Args... args) {
+        return (*static_cast<const Callable*>(context))(std::forward<Args>(args)...);
+    }
+
     template <typename Owner, R (Owner::*Method)(Args...)>
     static R invokeMember(void* context, Args... args) {
         return (static_cast<Owner*>(context)->*Method)(std::forward<Args>(args)...);
@@ -128,6 +209,8 @@ private:
     std::shared_ptr<void> holder_;
     void* context_ = nullptr;
     InvokeFn invoke_ = nullptr;
+    // 小 callable 的内联存储, 此时 context_ 指向这里
+    alignas(void*) unsigned char storage_[kInlineSize];
 };
 
 } // namespace internal
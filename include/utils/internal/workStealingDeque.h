@@ -0,0 +1,115 @@
+#ifndef UTILS_INTERNAL_WORK_STEALING_DEQUE_H
+#define UTILS_INTERNAL_WORK_STEALING_DEQUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace utils {
+namespace internal {
+
+// Chase-Lev 工作窃取双端队列(固定容量版本).
+// 1. 只有 owner 线程调用 push/pop, 在 bottom 端以 LIFO 方式操作, 无锁且通常无 CAS;
+// 2. 其他线程调用 steal, 在 top 端以 FIFO 方式窃取, 只在竞争最后一个元素时 CAS;
+// 3. 元素只存指针, 槽位本身是原子量, 避免 owner 写入和 thief 读取之间的数据竞争.
+// 容量固定为 2 的幂, push 失败时由调用方回退到全局队列, 不做扩容(扩容需要延迟回收旧数组).
+template <typename T>
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(std::size_t capacity = 256)
+        : capacity_(roundUpPow2(capacity)),
+          mask_(static_cast<int64_t>(capacity_ - 1)),
+          slots_(new std::atomic<T*>[capacity_]) {
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            slots_[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // owner 专用: 成功返回 true, 队列满返回 false
+    bool push(T* item) noexcept {
+        const int64_t b = bottom_.load(std::memory_order_relaxed);
+        const int64_t t = top_.load(std::memory_order_acquire);
+        if (b - t >= static_cast<int64_t>(capacity_)) return false;
+
+        slots_[b & mask_].store(item, std::memory_order_relaxed);
+        // release: 保证 thief 看到新的 bottom 时, 槽位内容已经可见
+        bottom_.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    // owner 专用: 从 bottom 端取出最近压入的元素, 为空返回 nullptr
+    T* pop() noexcept {
+        const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            // 已空, 恢复 bottom
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T* item = slots_[b & mask_].load(std::memory_order_relaxed);
+        if (t == b) {
+            // 只剩最后一个元素, 与 thief 通过 CAS 竞争
+            if (!top_.compare_exchange_strong(t, t + 1,
+                                              std::memory_order_seq_cst,
+                                              std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // 任意线程: 从 top 端窃取最早压入的元素, 为空或竞争失败返回 nullptr
+    T* steal() noexcept {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+
+        T* item = slots_[t & mask_].load(std::memory_order_relaxed);
+        if (!top_.compare_exchange_strong(t, t + 1,
+                                          std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+    // 近似元素数量, 仅用于统计与窃取前的快速跳过
+    std::size_t sizeApprox() const noexcept {
+        const int64_t b = bottom_.load(std::memory_order_relaxed);
+        const int64_t t = top_.load(std::memory_order_relaxed);
+        return b > t ? static_cast<std::size_t>(b - t) : 0;
+    }
+
+    bool emptyApprox() const noexcept { return sizeApprox() == 0; }
+
+    std::size_t capacity() const noexcept { return capacity_; }
+
+private:
+    static std::size_t roundUpPow2(std::size_t v) noexcept {
+        std::size_t cap = 2;
+        while (cap < v) cap <<= 1;
+        return cap;
+    }
+
+    // top 由 thief 竞争修改, bottom 只由 owner 修改, 分开缓存行避免伪共享
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+    alignas(64) const std::size_t capacity_;
+    const int64_t mask_;
+    std::unique_ptr<std::atomic<T*>[]> slots_;
+};
+
+} // namespace internal
+} // namespace utils
+
+#endif // UTILS_INTERNAL_WORK_STEALING_DEQUE_H
@@ -0,0 +1,321 @@
+/*
+ * @FilePath: /include/utils/lockFreeObjectPool.h
+ * @Author: SweerItTer xxxzhou.xian@gmail.com
+ * @Date: 2026-03-07
+ * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
+ * @Description: 无锁对象池, acquire/release 语义同 ObjectPool, 另提供自动归还的 RAII 句柄
+ */
+#ifndef LOCK_FREE_OBJECT_POOL_H
+#define LOCK_FREE_OBJECT_POOL_H
+
+/* ObjectPool 用 mutex + std::queue 保存空闲对象, 每次 acquire/release 都在同一把锁上串行.
+ * 这里改为固定槽位 + 两个无锁栈:
+ * 1. 对象原地构造在预分配的槽位里, 槽位下标在 "有对象" 栈和 "空槽" 栈之间流转;
+ *    栈顶编码为 {版本号, 下标}, CAS 时版本号递增, 避免 ABA;
+ * 2. Handle 直接引用槽位中的对象, 析构时只把下标压回栈, 对象本身不移动;
+ *    按值 acquire/release 保持与 ObjectPool 一致, 代价是一次对象移动;
+ * 3. 有界增长: 空闲对象用完且已创建数 < maxSize 时调用 creator 在新槽位构造,
+ *    达到上限后按策略阻塞等待(futex, 仅在确有等待者时唤醒)或立即失败;
+ *    creator 抛异常时槽位退回 "备用" 栈, 之后的 acquire 先复用它再增长, 容量不因构造失败而减少;
+ * 4. creator 只在增长时调用, 类型作为模板参数, 默认仍可传 std::function.
+ */
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "internal/futex.h"
+
+template <typename T, typename Creator = std::function<T()>>
+class LockFreeObjectPool {
+public:
+    // 对象耗尽(且已达到 maxSize)时的处理策略
+    enum class ExhaustedPolicy {
+        BLOCK,  // 阻塞等待其他线程归还
+        FAIL    // 立即失败(带超时的接口也不等待): Handle 为空, tryAcquire 返回 false, 按值 acquire 抛异常
+    };
+
+    // RAII 句柄: 持有期间独占槽位中的对象, 析构/reset 时自动归还
+    class Handle {
+    public:
+        Handle() noexcept = default;
+        Handle(const Handle&) = delete;
+        Handle& operator=(const Handle&) = delete;
+        Handle(Handle&& other) noexcept : pool_(other.pool_), index_(other.index_) {
+            other.pool_ = nullptr;
+        }
+        Handle& operator=(Handle&& other) noexcept {
+            if (this != &other) {
+                reset();
+                pool_ = other.pool_;
+                index_ = other.index_;
+                other.pool_ = nullptr;
+            }
+            return *this;
+        }
+        ~Handle() { reset(); }
+
+        T& operator*() const noexcept { return pool_->object(index_); }
+        T* operator->() const noexcept { return &pool_->object(index_); }
+        T* get() const noexcept { return pool_ ? &pool_->object(index_) : nullptr; }
+        explicit operator bool() const noexcept { return pool_ != nullptr; }
+
+        // 提前归还
+        void reset() noexcept {
+            if (pool_) {
+                pool_->pushFull(index_);
+                pool_ = nullptr;
+            }
+        }
+
+    private:
+        friend class LockFreeObjectPool;
+        Handle(LockFreeObjectPool* pool, uint32_t index) noexcept : pool_(pool), index_(index) {}
+
+        LockFreeObjectPool* pool_ = nullptr;
+        uint32_t index_ = 0;
+    };
+
+    /**
+     * @param poolSize 预先创建的对象数
+     * @param creator 构造对象的函数, 增长时也会调用
+     * @param maxSize 最多创建的对象数, 小于 poolSize 时按 poolSize 处理(不增长, 与 ObjectPool 相同)
+     * @param policy 对象耗尽时的策略
+     */
+    LockFreeObjectPool(size_t poolSize, Creator creator, size_t maxSize = 0,
+                       ExhaustedPolicy policy = ExhaustedPolicy::BLOCK)
+        : creator_(std::move(creator)),
+          capacity_(maxSize > poolSize ? maxSize : poolSize),
+          policy_(policy) {
+        if (capacity_ >= kNil) throw std::invalid_argument("LockFreeObjectPool maxSize too large");
+        slots_.reset(new Slot[capacity_]);
+        for (size_t i = 0; i < poolSize; ++i) {
+            const uint32_t index = static_cast<uint32_t>(i);
+            new (&slots_[index].storage) T(creator_());
+            slots_[index].hasObject = true;
+            created_.store(i + 1, std::memory_order_relaxed);
+            pushFull(index);
+        }
+    }
+
+    LockFreeObjectPool(const LockFreeObjectPool&) = delete;
+    LockFreeObjectPool& operator=(const LockFreeObjectPool&) = delete;
+
+    // 调用方保证析构时所有 Handle 已归还
+    ~LockFreeObjectPool() {
+        const size_t created = created_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < created; ++i) {
+            if (slots_[i].hasObject) object(static_cast<uint32_t>(i)).~T();
+        }
+    }
+
+    // ----------------- RAII 接口 -----------------
+
+    // 获取对象句柄; BLOCK 策略下耗尽时阻塞, FAIL 策略下返回空句柄
+    Handle acquireHandle() {
+        uint32_t index;
+        if (!acquireIndex(index, nullptr)) return Handle();
+        return Handle(this, index);
+    }
+
+    // 带超时获取句柄, 超时/失败返回空句柄; FAIL 策略下耗尽时不等待
+    Handle tryAcquireHandle(std::chrono::milliseconds timeout) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        uint32_t index;
+        if (!acquireIndex(index, &deadline)) return Handle();
+        return Handle(this, index);
+    }
+
+    // ----------------- 与 ObjectPool 相同的按值接口 -----------------
+
+    // 获取一个空闲对象, 如果没有则阻塞等待(FAIL 策略下抛出 std::runtime_error)
+    T acquire() {
+        uint32_t index;
+        if (!acquireIndex(index, nullptr)) throw std::runtime_error("LockFreeObjectPool exhausted");
+        return takeObject(index);
+    }
+
+    // BLOCK 策略下最多等待 timeout; FAIL 策略下耗尽时立即返回 false
+    bool tryAcquire(T& obj, std::chrono::milliseconds timeout) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        uint32_t index;
+        if (!acquireIndex(index, &deadline)) return false;
+        obj = takeObject(index);
+        return true;
+    }
+
+    // 归还对象回池; 所有槽位都已有对象时(归还了不是从本池取出的对象)直接销毁
+    void release(T obj) {
+        uint32_t index;
+        if (!pop(emptyHead_, index) && !claimFreshSlot(index)) return;
+        new (&slots_[index].storage) T(std::move(obj));
+        slots_[index].hasObject = true;
+        pushFull(index);
+    }
+
+    // 近似空闲对象数
+    size_t freeCount() const {
+        const int64_t n = free_.load(std::memory_order_relaxed);
+        return n > 0 ? static_cast<size_t>(n) : 0;
+    }
+    size_t createdCount() const { return created_.load(std::memory_order_relaxed); }
+    size_t maxSize() const { return capacity_; }
+
+private:
+    static constexpr uint32_t kNil = UINT32_MAX;
+    static constexpr int kSpinCount = 64;
+
+    struct Slot {
+        std::atomic<uint32_t> next{kNil};  // 栈中下一个槽位, 可能被并发 pop 读取
+        bool hasObject = false;            // 只由持有该槽位的线程读写
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    static uint64_t pack(uint32_t index, uint32_t tag) { return (static_cast<uint64_t>(tag) << 32) | index; }
+    static uint32_t indexOf(uint64_t head) { return static_cast<uint32_t>(head); }
+    static uint32_t tagOf(uint64_t head) { return static_cast<uint32_t>(head >> 32); }
+
+    T& object(uint32_t index) const noexcept {
+        return *reinterpret_cast<T*>(&slots_[index].storage);
+    }
+
+    void push(std::atomic<uint64_t>& head, uint32_t index) {
+        uint64_t cur = head.load(std::memory_order_relaxed);
+        do {
+            slots_[index].next.store(indexOf(cur), std::memory_order_relaxed);
+        } while (!head.compare_exchange_weak(cur, pack(index, tagOf(cur) + 1),
+                                             std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    bool pop(std::atomic<uint64_t>& head, uint32_t& index) {
+        uint64_t cur = head.load(std::memory_order_acquire);
+        while (indexOf(cur) != kNil) {
+            const uint32_t next = slots_[indexOf(cur)].next.load(std::memory_order_relaxed);
+            if (head.compare_exchange_weak(cur, pack(next, tagOf(cur) + 1),
+                                           std::memory_order_acquire, std::memory_order_acquire)) {
+                index = indexOf(cur);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 对象回到 "有对象" 栈, 有等待者时唤醒一个.
+    // free_ 递增与 waiters_ 读取都是 seq_cst, 与 acquireIndex 中 "登记 -> 读 free_" 配对, 不会漏唤醒
+    void pushFull(uint32_t index) {
+        push(fullHead_, index);
+        free_.fetch_add(1, std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_seq_cst) > 0) {
+            freeSeq_.fetch_add(1, std::memory_order_seq_cst);
+            utils::internal::futexWake(freeSeq_, 1);
+        }
+    }
+
+    bool popFull(uint32_t& index) {
+        if (!pop(fullHead_, index)) return false;
+        free_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 占用一个新槽位(未构造对象), 已达上限返回 false
+    bool growSlot(uint32_t& index) {
+        size_t created = created_.load(std::memory_order_relaxed);
+        while (created < capacity_) {
+            if (created_.compare_exchange_weak(created, created + 1, std::memory_order_acq_rel)) {
+                index = static_cast<uint32_t>(created);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 取一个从未放入对象的槽位: 先复用构造失败退回的槽位, 再增长
+    bool claimFreshSlot(uint32_t& index) {
+        return pop(spareHead_, index) || growSlot(index);
+    }
+
+    T takeObject(uint32_t index) {
+        T obj(std::move(object(index)));
+        object(index).~T();
+        slots_[index].hasObject = false;
+        push(emptyHead_, index);
+        return obj;
+    }
+
+    // 取得一个持有对象的槽位: 空闲对象 -> 有界增长 -> 按策略等待
+    bool acquireIndex(uint32_t& index, const std::chrono::steady_clock::time_point* deadline) {
+        if (popFull(index)) return true;
+        if (claimFreshSlot(index)) {
+            construct(index);
+            return true;
+        }
+        if (policy_ == ExhaustedPolicy::FAIL) return false;
+
+        for (int i = 0; i < kSpinCount; ++i) {
+            if (popFull(index)) return true;
+            utils::internal::cpuRelax();
+        }
+
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        bool ok = false;
+        bool fresh = false;
+        while (true) {
+            const uint32_t seq = freeSeq_.load(std::memory_order_seq_cst);
+            if (free_.load(std::memory_order_seq_cst) > 0 && popFull(index)) {
+                ok = true;
+                break;
+            }
+            // 其他线程构造失败退回了槽位
+            if (pop(spareHead_, index)) {
+                ok = fresh = true;
+                break;
+            }
+            if (!deadline) {
+                utils::internal::futexWait(freeSeq_, seq);
+                continue;
+            }
+            const auto left = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                *deadline - std::chrono::steady_clock::now());
+            if (left.count() <= 0) break;
+            utils::internal::futexWait(freeSeq_, seq, &left);
+        }
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+        if (fresh) construct(index);
+        return ok;
+    }
+
+    void construct(uint32_t index) {
+        try {
+            new (&slots_[index].storage) T(creator_());
+        } catch (...) {
+            // 槽位已计入 created_ 但没有对象: 退回备用栈, 并唤醒可能因 "已达上限" 而等待的线程.
+            // freeSeq_ 无条件递增, 与等待方 "登记 -> 读 freeSeq_ -> pop 备用栈" 配对, 不会漏唤醒
+            push(spareHead_, index);
+            freeSeq_.fetch_add(1, std::memory_order_seq_cst);
+            if (waiters_.load(std::memory_order_seq_cst) > 0) utils::internal::futexWake(freeSeq_, 1);
+            throw;
+        }
+        slots_[index].hasObject = true;
+    }
+
+    Creator creator_;
+    std::unique_ptr<Slot[]> slots_;
+    size_t capacity_;
+    ExhaustedPolicy policy_;
+
+    alignas(64) std::atomic<uint64_t> fullHead_{pack(kNil, 0)};   // 持有空闲对象的槽位栈
+    alignas(64) std::atomic<uint64_t> emptyHead_{pack(kNil, 0)};  // 对象已被按值取走的空槽位栈
+    std::atomic<uint64_t> spareHead_{pack(kNil, 0)};              // creator 抛异常后退回的槽位栈, 很少变动
+    alignas(64) std::atomic<size_t> created_{0};
+    alignas(64) std::atomic<int64_t> free_{0};  // 入栈后才递增, 出栈后才递减, 可能短暂为负
+    std::atomic<uint32_t> freeSeq_{0};    // 对象归还序号, 等待者在其上 futex 休眠
+    std::atomic<uint32_t> waiters_{0};
+};
+
+#endif // LOCK_FREE_OBJECT_POOL_H
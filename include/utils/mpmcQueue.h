@@ -0,0 +1,309 @@
+/*
+ * @FilePath: /include/utils/mpmcQueue.h
+ * @Author: SweerItTer xxxzhou.xian@gmail.com
+ * @Date: 2026-03-02
+ * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
+ * @Description: 无锁有界多生产者多消费者队列, 接口与溢出策略同 SafeQueue
+ */
+#ifndef MPMC_QUEUE_H
+#define MPMC_QUEUE_H
+
+/* 基于序号槽位的环形队列(Vyukov bounded MPMC):
+ * 1. 每个槽位带一个 stamp, 生产者/消费者只通过 CAS 推进 tail_/head_, 热路径不加锁;
+ * 2. head_/tail_ 编码为 {圈数, 下标}, 下标走到容量末尾时直接进位到下一圈,
+ *    因此容量不必是 2 的幂, 语义与 SafeQueue 完全一致, 也没有 % 运算;
+ * 3. 只有阻塞等待(dequeue 队列空, BLOCK 策略队列满)才使用 mutex + condition_variable,
+ *    且仅在确有等待者时才加锁通知.
+ */
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+
+// 主模板声明, 与 SafeQueue 一样只对智能指针特化
+template <typename T, typename Enable = void>
+class MpmcQueue;
+
+template <typename Ptr>
+class MpmcQueue<Ptr, typename std::enable_if<
+    std::is_same<Ptr, std::shared_ptr<typename Ptr::element_type>>::value ||
+    std::is_same<Ptr, std::unique_ptr<typename Ptr::element_type>>::value
+>::type> {
+public:
+    // 溢出策略枚举(同 SafeQueue::OverflowPolicy)
+    enum class OverflowPolicy {
+        DISCARD_OLDEST,  // 丢弃最旧的项目
+        DISCARD_NEWEST,  // 丢弃最新的项目
+        BLOCK,           // 阻塞直到有空间
+        THROW_EXCEPTION  // 抛出异常
+    };
+
+    explicit MpmcQueue(size_t capacity, OverflowPolicy policy = OverflowPolicy::DISCARD_OLDEST)
+        : policy_(policy) {
+        init(capacity);
+    }
+
+    // 禁止拷贝
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    // 允许移动(调用方保证移动时两个队列都没有并发访问)
+    MpmcQueue(MpmcQueue&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    MpmcQueue& operator=(MpmcQueue&& other) noexcept {
+        if (this != &other) {
+            slots_ = std::move(other.slots_);
+            capacity_ = other.capacity_;
+            oneLap_ = other.oneLap_;
+            head_.store(other.head_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            tail_.store(other.tail_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            policy_ = other.policy_;
+            shutdown_.store(other.shutdown_.load());
+
+            // 重置源对象状态
+            other.capacity_ = 0;
+            other.oneLap_ = 1;
+            other.head_.store(0, std::memory_order_relaxed);
+            other.tail_.store(0, std::memory_order_relaxed);
+            other.shutdown_.store(true);
+        }
+        return *this;
+    }
+
+    ~MpmcQueue() {
+        shutdown();
+        clear();
+    }
+
+    size_t getBufferRealSize() { return capacity_; }
+
+    void shutdown() {
+        shutdown_.store(true);
+        std::lock_guard<std::mutex> lock(waitMutex_);
+        not_empty_cond_.notify_all();
+        not_full_cond_.notify_all();
+    }
+
+    // 入队操作 - 接受对象的唯一所有权
+    bool enqueue(Ptr&& item) {
+        if (shutdown_.load(std::memory_order_relaxed)) {
+            return false; // 已关闭, 不允许入队
+        }
+
+        while (!tryPush(item)) {
+            switch (policy_) {
+                case OverflowPolicy::DISCARD_OLDEST: {
+                    // 与其他生产者竞争时可能连续让位, 每轮丢一个最旧的再重试
+                    Ptr oldest;
+                    tryPop(oldest);
+                    break;
+                }
+                case OverflowPolicy::DISCARD_NEWEST:
+                    return false;
+                case OverflowPolicy::BLOCK:
+                    return blockingPush(item);
+                case OverflowPolicy::THROW_EXCEPTION:
+                    throw std::runtime_error("Queue is full");
+            }
+        }
+
+        notifyWaiters(not_empty_waiters_, not_empty_cond_);
+        return true;
+    }
+
+    // 阻塞式出队 - 返回对象的唯一所有权, 队列关闭且为空时返回 nullptr
+    Ptr dequeue() {
+        Ptr item;
+        if (tryPop(item)) {
+            notifyWaiters(not_full_waiters_, not_full_cond_);
+            return item;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(waitMutex_);
+            not_empty_waiters_.fetch_add(1, std::memory_order_seq_cst);
+            not_empty_cond_.wait(lock, [&] {
+                return tryPop(item) || shutdown_.load();
+            });
+            not_empty_waiters_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        if (!item) return nullptr; // 返回空, 表示队列关闭
+
+        notifyWaiters(not_full_waiters_, not_full_cond_);
+        return item;
+    }
+
+    using element = typename Ptr::element_type;
+    // 查看队头元素, 仅在没有其他消费者并发出队时安全(与 SafeQueue::front 相同的约束)
+    element* front() const {
+        if (capacity_ == 0) return nullptr;
+        const size_t head = head_.load(std::memory_order_acquire);
+        const Slot& slot = slots_[head & (oneLap_ - 1)];
+        if (slot.stamp.load(std::memory_order_acquire) != head + 1) return nullptr;
+        return slot.value.get();
+    }
+
+    // 非阻塞尝试出队
+    bool try_dequeue(Ptr& item) {
+        if (!tryPop(item)) return false;
+        notifyWaiters(not_full_waiters_, not_full_cond_);
+        return true;
+    }
+
+    void clear() {
+        Ptr item;
+        while (tryPop(item)) {
+            item.reset();
+        }
+        notifyWaiters(not_full_waiters_, not_full_cond_, true);
+    }
+
+    // 近似大小: 并发修改时只保证返回某一时刻附近的值
+    size_t size() const {
+        for (;;) {
+            const size_t tail = tail_.load(std::memory_order_seq_cst);
+            const size_t head = head_.load(std::memory_order_seq_cst);
+            if (tail_.load(std::memory_order_seq_cst) != tail) continue;
+
+            const size_t hix = head & (oneLap_ - 1);
+            const size_t tix = tail & (oneLap_ - 1);
+            if (hix < tix) return tix - hix;
+            if (hix > tix) return capacity_ - hix + tix;
+            return tail == head ? 0 : capacity_;
+        }
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+private:
+    static constexpr size_t kCacheLine = 64;
+
+    struct Slot {
+        std::atomic<size_t> stamp{0};   // == 位置: 可写; == 位置 + 1: 可读
+        Ptr value;
+    };
+
+    void init(size_t capacity) {
+        if (capacity == 0) throw std::invalid_argument("MpmcQueue capacity must be > 0");
+        capacity_ = capacity;
+        // 低位放下标, 高位放圈数
+        oneLap_ = 1;
+        while (oneLap_ < capacity_ + 1) oneLap_ <<= 1;
+        slots_.reset(new Slot[capacity_]);
+        for (size_t i = 0; i < capacity_; ++i) {
+            slots_[i].stamp.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // 下一个位置: 本圈未走完则 +1, 否则进位到下一圈的 0 号下标
+    size_t advance(size_t pos) const {
+        const size_t index = pos & (oneLap_ - 1);
+        const size_t lap = pos & ~(oneLap_ - 1);
+        return index + 1 < capacity_ ? pos + 1 : lap + oneLap_;
+    }
+
+    // 成功时移走 item, 队列满返回 false 且不改动 item
+    bool tryPush(Ptr& item) {
+        if (capacity_ == 0) return false; // 已被移走
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[tail & (oneLap_ - 1)];
+            const size_t stamp = slot.stamp.load(std::memory_order_seq_cst);
+
+            if (stamp == tail) {
+                if (tail_.compare_exchange_weak(tail, advance(tail),
+                                                std::memory_order_seq_cst,
+                                                std::memory_order_relaxed)) {
+                    slot.value = std::move(item);
+                    slot.stamp.store(tail + 1, std::memory_order_seq_cst);
+                    return true;
+                }
+            } else if (stamp + oneLap_ == tail + 1) {
+                // 槽位还是上一圈的数据: 确认 head 没有推进才算满
+                const size_t head = head_.load(std::memory_order_seq_cst);
+                if (head + oneLap_ == tail) return false;
+                tail = tail_.load(std::memory_order_relaxed);
+            } else {
+                // tail 已被其他生产者推进, 重新读取
+                tail = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPop(Ptr& item) {
+        if (capacity_ == 0) return false; // 已被移走
+        size_t head = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[head & (oneLap_ - 1)];
+            const size_t stamp = slot.stamp.load(std::memory_order_seq_cst);
+
+            if (stamp == head + 1) {
+                if (head_.compare_exchange_weak(head, advance(head),
+                                                std::memory_order_seq_cst,
+                                                std::memory_order_relaxed)) {
+                    item = std::move(slot.value);
+                    slot.stamp.store(head + oneLap_, std::memory_order_seq_cst);
+                    return true;
+                }
+            } else if (stamp == head) {
+                // 槽位尚未写入: 确认 tail 没有推进才算空
+                const size_t tail = tail_.load(std::memory_order_seq_cst);
+                if (tail == head) return false;
+                head = head_.load(std::memory_order_relaxed);
+            } else {
+                head = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool blockingPush(Ptr& item) {
+        bool pushed = false;
+        {
+            std::unique_lock<std::mutex> lock(waitMutex_);
+            not_full_waiters_.fetch_add(1, std::memory_order_seq_cst);
+            not_full_cond_.wait(lock, [&] {
+                return shutdown_.load() || (pushed = tryPush(item));
+            });
+            not_full_waiters_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        if (pushed) notifyWaiters(not_empty_waiters_, not_empty_cond_);
+        return pushed;
+    }
+
+    // stamp 的读写都是 seq_cst, 与等待方的 fetch_add(seq_cst) 构成 Dekker 式配对:
+    // "写槽位 -> 读等待数" 与 "写等待数 -> 读槽位" 不会同时读到旧值, 因此不会漏唤醒
+    void notifyWaiters(std::atomic<size_t>& waiters, std::condition_variable& cond, bool all = false) {
+        if (waiters.load(std::memory_order_seq_cst) == 0) return;
+        std::lock_guard<std::mutex> lock(waitMutex_);
+        if (all) cond.notify_all();
+        else cond.notify_one();
+    }
+
+    // 生产者和消费者各自独占一条 cache line
+    std::atomic<size_t> head_{0};
+    char headPad_[kCacheLine - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> tail_{0};
+    char tailPad_[kCacheLine - sizeof(std::atomic<size_t>)];
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t capacity_ = 0;
+    size_t oneLap_ = 1;             // 2 的幂, 大于容量
+
+    std::atomic<bool> shutdown_{false};
+    std::mutex waitMutex_;
+    std::condition_variable not_empty_cond_;
+    std::condition_variable not_full_cond_;
+    std::atomic<size_t> not_empty_waiters_{0};
+    std::atomic<size_t> not_full_waiters_{0};
+
+    OverflowPolicy policy_;
+};
+
+#endif // MPMC_QUEUE_H
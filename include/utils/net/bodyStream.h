@@ -0,0 +1,82 @@
+/*
+ * @FilePath: /include/utils/net/bodyStream.h
+ * @Author: SweerItTer xxxzhou.xian@gmail.com
+ * @Date: 2026-03-15
+ * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
+ * @Description: Bounded chunk queue backing streamed response bodies
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace utils {
+namespace net {
+
+/*
+ * BodyStream - 流式响应体
+ * 生产端在任意线程 write() 追加分块, 结束时 close(); reactor 只在 socket 可写且之前取走的数据已全部写出时
+ * 才再次 read(), 因此缓冲数据不超过 maxBufferedBytes (外加一个分块), 超过时 write() 阻塞, 对端读得慢就反压到生产端.
+ * 连接断开或响应被丢弃时流被取消, 之后 write() 立即返回 false, 生产端据此停止.
+ *
+ * 注意: handler 返回之前响应还没有交给 reactor, 在 handler 内最多写入 maxBufferedBytes,
+ * 持续产生的数据应交给其他线程写入.
+ */
+class BodyStream {
+public:
+    enum class ReadStatus : uint8_t {
+        DATA,   // 取到了分块
+        WAIT,   // 暂无数据, 下次 write()/close()/abort() 时回调 onReady
+        END,    // 已 close() 且数据已取完
+        ABORTED // 生产端 abort(), 响应不完整, 连接应关闭
+    };
+
+    static constexpr size_t kDefaultMaxBufferedBytes = 256 * 1024;
+
+    explicit BodyStream(size_t maxBufferedBytes = kDefaultMaxBufferedBytes) : maxBuffered_(maxBufferedBytes) {}
+
+    BodyStream(const BodyStream&) = delete;
+    BodyStream& operator=(const BodyStream&) = delete;
+
+    // ---- 生产端 ----
+    // 追加一个分块 (空分块忽略); 缓冲已满时阻塞; 流已结束或被取消返回 false
+    bool write(std::string chunk);
+    // 正常结束, 已写入的数据仍会发完
+    void close();
+    // 异常结束, reactor 直接关闭连接
+    void abort();
+    // 对端已断开或响应被丢弃
+    bool cancelled() const;
+
+    // ---- reactor 端 ----
+    void setReadyCallback(std::function<void()> onReady);
+    // 取走当前缓存的全部分块
+    ReadStatus read(std::deque<std::string>& out);
+    // 消费端放弃该流, 唤醒阻塞的 write()
+    void cancel();
+
+private:
+    void notifyReady();
+
+    mutable std::mutex mutex_;
+    std::condition_variable writable_;
+    std::deque<std::string> chunks_;
+    size_t buffered_{0};
+    const size_t maxBuffered_;
+    bool closed_{false};
+    bool aborted_{false};
+    bool cancelled_{false};
+    bool waiting_{false}; // reactor 上次 read() 得到 WAIT
+    std::function<void()> onReady_;
+};
+
+using BodyStreamPtr = std::shared_ptr<BodyStream>;
+
+} // namespace net
+} // namespace utils
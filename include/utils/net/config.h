@@ -28,8 +28,9 @@ struct PluginInstanceConfig {
 };
 
 struct RouteConfig {
-    std::string method;
-    std::string path;
+    std::string method; // mount 为真时为空
+    std::string path;   // 精确路径或模式 ("/users/:id"); mount 为真时是挂载前缀
+    bool mount{false};  // JSON 中用 "mount": "/prefix" 代替 method + path, 任意方法
     std::string pluginName;
     std::string handlerName;
 };
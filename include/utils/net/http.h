@@ -11,6 +11,7 @@
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "json.h"
 #include "response.h"
@@ -18,15 +19,31 @@
 namespace utils {
 namespace net {
 
+// 头部名按 ASCII 大小写不敏感比较, 保留原始写法, 查找时无需先转小写
+struct HeaderNameHash {
+    size_t operator()(const std::string& name) const;
+};
+
+struct HeaderNameEqual {
+    bool operator()(const std::string& a, const std::string& b) const;
+};
+
+using HttpHeaders = std::unordered_map<std::string, std::string, HeaderNameHash, HeaderNameEqual>;
+// 路由捕获的路径参数, 通常只有一两个, 线性查找比哈希表省一次分配
+using HttpParams = std::vector<std::pair<std::string, std::string>>;
+
 struct HttpRequest {
     std::string method;
     std::string target;
     std::string version; // "HTTP/1.1"
-    std::unordered_map<std::string, std::string> headers;
-    std::string body; // optional; v1 supports Content-Length only
+    HttpHeaders headers;
+    std::string body; // Content-Length 或已解码的 chunked 请求体
+    HttpParams params; // 由 HttpRouter 在命中模式路由 / 前缀挂载时填写
 
     // 返回去掉 query string 的请求路径.
     std::string path() const;
+    // 返回路径参数 (:name / *name) 的原始值, 不存在时返回空串.
+    const std::string& param(const std::string& name) const;
     // 将 body 解析为 JSON 对象, 便于插件直接处理结构化 API 请求.
     bool parseJsonBody(JsonValue& outValue, std::string& error) const;
 };
@@ -83,6 +100,13 @@ public:
         return std::move(bodyFromDmaBuf(std::move(buf), offset, length));
     }
 
+    // 流式响应体, 以 Transfer-Encoding: chunked 发送 (不带 Content-Length)
+    HttpResponse& bodyFromStream(BodyStreamPtr stream) & {
+        body_ = Body::fromStream(std::move(stream));
+        return *this;
+    }
+    HttpResponse&& bodyFromStream(BodyStreamPtr stream) && { return std::move(bodyFromStream(std::move(stream))); }
+
     // Consumes internal body (may hold move-only fd).
     Response toResponse();
 
@@ -0,0 +1,108 @@
+/*
+ * @FilePath: /include/utils/net/httpParser.h
+ * @Author: SweerItTer xxxzhou.xian@gmail.com
+ * @Date: 2026-03-11
+ * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
+ * @Description: Resumable HTTP/1.1 request parser working in place on the connection buffer
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "http.h"
+
+namespace utils {
+namespace net {
+
+/*
+ * HttpRequestParser - 增量状态机解析器
+ * 直接在连接缓冲区上按偏移扫描, 只在请求完整时把各字段拷贝一次到 HttpRequest.
+ * 部分到达的数据不会重复扫描: 解析器记住已扫描到的位置, 下次从那里继续.
+ *
+ * 用法: data 指向当前请求的起点 (上一个请求 consumed() 之后), len 为已缓存的字节数.
+ * 同一请求的多次调用之间, 缓冲区可以扩容搬移 (只记偏移), 但起点之前的数据不能被再次插入.
+ *
+ * 请求体支持 Content-Length 与 Transfer-Encoding: chunked. chunked 时记录各数据块的偏移,
+ * 请求完整后拼接为解码后的 body (trailer 字段被跳过); 两者同时出现视为非法 (防止请求走私).
+ */
+class HttpRequestParser {
+public:
+    enum class Status : uint8_t {
+        NEED_MORE, // 请求尚不完整, 等待更多数据
+        COMPLETE,  // 已解析出一个请求, consumed() 为其占用的字节数
+        ERROR      // 请求非法, error() 给出原因; 调用 reset() 前一直保持该状态
+    };
+
+    struct Limits {
+        size_t maxHeaderBytes{64 * 1024};       // 请求行 + 头部上限
+        uint64_t maxBodyBytes{64 * 1024 * 1024}; // Content-Length / chunked 解码后长度上限
+    };
+
+    HttpRequestParser() = default;
+    explicit HttpRequestParser(Limits limits) : limits_(limits) {}
+
+    Status parse(const char* data, size_t len, HttpRequest& out);
+
+    // 最近一次 COMPLETE 的请求在缓冲区中占用的字节数
+    size_t consumed() const { return consumed_; }
+    const char* error() const { return error_; }
+    // 请求头已收齐, 正在等待请求体
+    bool inBody() const { return state_ != State::FAILED && state_ >= State::BODY; }
+
+    void reset();
+
+private:
+    enum class State : uint8_t {
+        REQUEST_LINE,
+        HEADERS,
+        BODY,       // Content-Length
+        CHUNK_SIZE, // chunked: "hex[;ext]" 行
+        CHUNK_DATA,
+        CHUNK_END,  // 数据块后的空行
+        TRAILERS,
+        FAILED
+    };
+
+    struct Span {
+        size_t offset{0};
+        size_t length{0};
+    };
+
+    struct HeaderSpan {
+        Span name;
+        Span value;
+    };
+
+    bool parseRequestLine(const char* data, size_t begin, size_t end);
+    bool parseHeaderLine(const char* data, size_t begin, size_t end);
+    // 处理一个完整行 [begin, end), next 为下一行起点; 返回 false 表示已 fail()
+    bool onLine(const char* data, size_t begin, size_t end, size_t next);
+    bool parseChunkSize(const char* data, size_t begin, size_t end);
+    Status fail(const char* reason);
+    void emit(const char* data, HttpRequest& out) const;
+
+    Limits limits_;
+    State state_{State::REQUEST_LINE};
+    size_t lineStart_{0}; // 当前行起点
+    size_t scanned_{0};   // 已确认不含 '\n' 的位置
+    size_t bodyStart_{0};
+    uint64_t contentLength_{0};
+    bool hasContentLength_{false};
+    bool chunked_{false};
+    uint64_t chunkLeft_{0};  // 当前数据块长度
+    size_t sectionStart_{0}; // trailer 段起点, 用于长度限制
+    size_t requestEnd_{0};   // chunked: 请求结束位置
+    size_t consumed_{0};
+    const char* error_{nullptr};
+
+    Span method_;
+    Span target_;
+    Span version_;
+    std::vector<HeaderSpan> headers_; // 复用容量, 避免每个请求重新分配
+    std::vector<Span> chunks_;        // chunked 数据块在缓冲区中的位置
+};
+
+} // namespace net
+} // namespace utils
@@ -0,0 +1,94 @@
+/*
+ * @FilePath: /include/utils/net/inputBuffer.h
+ * @Author: SweerItTer xxxzhou.xian@gmail.com
+ * @Date: 2026-03-12
+ * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
+ * @Description: Connection input buffer with a read cursor and lazy compaction
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+namespace utils {
+namespace net {
+
+/*
+ * InputBuffer - 连接接收缓冲
+ * [0, read_) 已消费, [read_, write_) 待解析, [write_, capacity_) 可写.
+ * consume() 只推进读游标; 只有在需要写空间时才把未消费数据搬到开头, 因此逐行消费是线性的.
+ * recv 直接写入 prepare() 返回的空间, 不经过中间拷贝.
+ */
+class InputBuffer {
+public:
+    InputBuffer() = default;
+    InputBuffer(InputBuffer&& other) noexcept { *this = std::move(other); }
+
+    InputBuffer& operator=(InputBuffer&& other) noexcept {
+        if (this != &other) {
+            buf_ = std::move(other.buf_);
+            capacity_ = other.capacity_;
+            read_ = other.read_;
+            write_ = other.write_;
+            other.capacity_ = other.read_ = other.write_ = 0;
+        }
+        return *this;
+    }
+
+    const char* data() const { return buf_.get() + read_; }
+    size_t size() const { return write_ - read_; }
+    bool empty() const { return write_ == read_; }
+
+    // 保证至少 n 字节可写空间, 返回写入位置; 写入后调用 commit()
+    char* prepare(size_t n) {
+        if (capacity_ - write_ >= n) return buf_.get() + write_;
+
+        const size_t pending = size();
+        if (read_ > 0 && capacity_ - pending >= n && read_ >= pending) {
+            // 已消费部分不少于剩余数据: 原地前移, 摊还 O(1)
+            std::memmove(buf_.get(), buf_.get() + read_, pending);
+        } else {
+            size_t cap = capacity_ ? capacity_ : kInitialCapacity;
+            while (cap - pending < n) cap *= 2;
+            std::unique_ptr<char[]> grown(new char[cap]);
+            if (pending) std::memcpy(grown.get(), buf_.get() + read_, pending);
+            buf_ = std::move(grown);
+            capacity_ = cap;
+        }
+        read_ = 0;
+        write_ = pending;
+        return buf_.get() + write_;
+    }
+
+    size_t writable() const { return capacity_ - write_; }
+
+    void commit(size_t n) { write_ += n; }
+
+    void consume(size_t n) {
+        read_ += n;
+        if (read_ >= write_) read_ = write_ = 0;
+    }
+
+    void clear() { read_ = write_ = 0; }
+
+    // 空闲时释放突发流量撑大的内存
+    void shrinkIfIdle(size_t keepCapacity = kInitialCapacity * 8) {
+        if (empty() && capacity_ > keepCapacity) {
+            buf_.reset();
+            capacity_ = 0;
+        }
+    }
+
+private:
+    static constexpr size_t kInitialCapacity = 8192;
+
+    std::unique_ptr<char[]> buf_;
+    size_t capacity_{0};
+    size_t read_{0};
+    size_t write_{0};
+};
+
+} // namespace net
+} // namespace utils
@@ -3,7 +3,7 @@
  * @Author: SweerItTer xxxzhou.xian@gmail.com
  * @Date: 2026-02-22
  * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
- * @Description: NET 响应体 - 可表达 bytes / file-fd / dmabuf 内容发送
+ * @Description: NET 响应体 - 可表达 bytes / file-fd / dmabuf / 流式内容发送
  */
 #pragma once
 
@@ -14,6 +14,7 @@
 #include <utility>
 
 #include "fdWrapper.h"
+#include "bodyStream.h"
 
 class DmaBuffer;
 using DmaBufferPtr = std::shared_ptr<DmaBuffer>;
@@ -26,7 +27,8 @@ struct Body {
         EMPTY,
         BYTES,
         FILE_FD,
-        DMABUF
+        DMABUF,
+        STREAM
     };
 
     struct FileFd {
@@ -41,10 +43,31 @@ struct Body {
         uint64_t length{0};
     };
 
+    // 析构时取消流: 响应在发出前被丢弃 (如连接已断开) 时, 生产端的 write() 不会一直阻塞
+    struct Stream {
+        BodyStreamPtr source;
+        bool chunked{false}; // 按 HTTP/1.1 chunked 编码分帧, 由 HttpResponse 设置
+
+        Stream() = default;
+        Stream(Stream&& other) noexcept = default;
+        Stream& operator=(Stream&& other) noexcept {
+            if (this != &other) {
+                if (source) source->cancel();
+                source = std::move(other.source);
+                chunked = other.chunked;
+            }
+            return *this;
+        }
+        ~Stream() {
+            if (source) source->cancel();
+        }
+    };
+
     Kind kind{Kind::EMPTY};
     std::string bytes;
     FileFd file;
     DmaBuf dmabuf;
+    Stream stream;
 
     static Body empty() { return Body{}; }
 
@@ -72,6 +95,13 @@ struct Body {
         b.dmabuf.length = length;
         return b;
     }
+
+    static Body fromStream(BodyStreamPtr source) {
+        Body b;
+        b.kind = Kind::STREAM;
+        b.stream.source = std::move(source);
+        return b;
+    }
 };
 
 struct Response {
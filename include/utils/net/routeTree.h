@@ -0,0 +1,55 @@
+/*
+ * @FilePath: /include/utils/net/routeTree.h
+ * @Author: SweerItTer xxxzhou.xian@gmail.com
+ * @Date: 2026-03-16
+ * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
+ * @Description: Radix tree matching HTTP path patterns with parameters and wildcards
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "http.h"
+
+namespace utils {
+namespace net {
+
+// RouteTree - 路径模式的基数树 (公共前缀压缩)
+// 模式语法:
+//   /users/:id          ":name" 占据一整段, 匹配到下一个 '/' 之前的非空内容
+//   /files/*path        "*name" 只能位于末尾, 匹配剩余全部 (可为空), name 省略时参数名为 "*"
+// 同一位置静态段优先于 :name, :name 优先于 *name; 优先分支走不通时回溯.
+// 同一位置的参数名必须一致, 否则 insert() 失败.
+// 只负责匹配, 命中时返回 insert() 传入的 routeId; 不加锁, 与 HttpRouter 一样应在 start() 前注册完.
+class RouteTree {
+public:
+    RouteTree();
+    ~RouteTree();
+
+    RouteTree(RouteTree&&) noexcept;
+    RouteTree& operator=(RouteTree&&) noexcept;
+
+    // 模式非法 / 与已有模式冲突 / 重复注册返回 false
+    bool insert(const std::string& pattern, size_t routeId, std::string* error = nullptr);
+    // 命中返回 true, 捕获的参数追加到 params (未命中时 params 恢复原样)
+    bool match(const std::string& path, size_t& routeId, HttpParams& params) const;
+
+    bool empty() const { return !root_; }
+
+    // path 中是否有以 ':' 或 '*' 开头的段
+    static bool isPattern(const std::string& path);
+
+private:
+    struct Node;
+
+    static Node* insertStatic(Node* cur, const std::string& s);
+    static bool matchNode(const Node* n, const std::string& path, size_t pos, size_t& routeId, HttpParams& params);
+
+    std::unique_ptr<Node> root_;
+};
+
+} // namespace net
+} // namespace utils
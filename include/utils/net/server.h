@@ -19,6 +19,7 @@
 #include "http.h"
 #include "line.h"
 #include "response.h"
+#include "routeTree.h"
 
 namespace utils {
 namespace net {
@@ -29,13 +30,23 @@ struct ServerConfig {
     uint32_t maxClients{128};
 
     // IO and worker threading
-    uint32_t ioThreads{1}; // v1 uses 1
+    // reactor 线程数, 每个 reactor 独占 epoll 与连接表
+    uint32_t ioThreads{1};
+    // ioThreads > 1 时每个 reactor 用 SO_REUSEPORT 独立监听; 关闭或不可用时由单个 acceptor 轮询分发
+    bool reusePort{true};
     uint32_t workerThreadsMin{2};
     uint32_t workerThreadsMax{8};
     uint32_t workerQueueSize{128};
 
     // Connection management
+    // 连接无读写的时限, 等待 handler / 流式响应生产端期间同样计时; <= 0 不限
     int idleTimeoutSec{15};
+    // 从收到请求的第一个字节到请求头 (行协议为整行) 收齐的时限, 防止 slowloris 式慢速发送; <= 0 不限
+    int requestHeaderTimeoutSec{10};
+    // 请求头收齐后请求体收齐的时限; <= 0 不限
+    int requestBodyTimeoutSec{30};
+    // 每个连接已分发但响应未发出的请求上限; 达到后暂停读取该连接 (HTTP pipelining 背压)
+    uint32_t maxPipelinedRequests{16};
 
     // TCP keepalive (socket options)
     bool enableTcpKeepAlive{true};
@@ -44,6 +55,15 @@ struct ServerConfig {
     int tcpKeepCount{5};
 };
 
+// 各 reactor 计数之和, 运行中读取为近似值
+struct ServerStats {
+    uint64_t connectionsAccepted{0};
+    uint64_t responsesSent{0};  // 已完整写入 socket 的响应
+    uint64_t writeSyscalls{0};  // sendmsg / send / sendfile 调用次数, 含返回 EAGAIN 的调用
+    uint64_t pollUpdates{0};    // epoll_ctl(MOD) 次数 (切换 EPOLLOUT / 暂停读取)
+    uint64_t timedOutConnections{0}; // 因空闲或请求头/体超时被关闭的连接
+};
+
 struct PeerInfo {
     std::string ip;
     uint16_t port{0};
@@ -70,6 +90,8 @@ class HttpRouter {
 public:
     using MethodHandlers = std::unordered_map<std::string, HttpHandler>;
 
+    // path 可以是精确路径, 也可以是模式 (见 RouteTree): "/users/:id", "/files/*path";
+    // 命中模式时捕获的参数写入 HttpRequest::params. 精确路径优先于模式.
     bool on(std::string method, std::string path, HttpHandler handler);
     bool get(std::string path, HttpHandler handler);
     bool head(std::string path, HttpHandler handler);
@@ -79,11 +101,18 @@ public:
     bool patch(std::string path, HttpHandler handler);
     bool options(std::string path, HttpHandler handler);
 
+    // 把 prefix 及其下所有路径 (任意方法) 交给 handler, 剩余部分 (不含开头的 '/') 在 req.param("*").
+    // 只在按方法注册的路由都未命中时生效. Example:
+    // mount("/api/v2", legacyHandler);
+    bool mount(std::string prefix, HttpHandler handler);
+
     // Serve a whole directory under a URL prefix. Example:
     // staticDir("/static/", "www");
     void staticDir(std::string urlPrefix, std::string directory);
 
+    // 命中模式路由时需要写入 params, const 版本会复制一份请求
     Response dispatch(const ConnectionContext& ctx, const HttpRequest& req) const;
+    Response dispatch(const ConnectionContext& ctx, HttpRequest& req) const;
 
 private:
     struct StaticDir {
@@ -91,7 +120,13 @@ private:
         std::string dir;
     };
 
-    std::unordered_map<std::string, MethodHandlers> handlers_;
+    Response route(const ConnectionContext& ctx, const HttpRequest& req, HttpRequest* writable) const;
+    bool pathExistsInAnyMethod(const std::string& path) const;
+
+    std::unordered_map<std::string, MethodHandlers> handlers_; // 精确路径, 一次哈希查找
+    std::unordered_map<std::string, RouteTree> patterns_;      // 按方法的模式路由
+    RouteTree mounts_;                                         // 前缀挂载, 不区分方法
+    std::vector<HttpHandler> routeHandlers_;                   // 以 RouteTree 的 routeId 为下标
     std::vector<StaticDir> staticDirs_;
 };
 
@@ -108,6 +143,8 @@ public:
     void join();
 
     bool isRunning() const { return running_.load(); }
+    // start() 之后调用
+    ServerStats getStats() const;
 
     LineRouter& line() { return lineRouter_; }
     HttpRouter& http() { return httpRouter_; }
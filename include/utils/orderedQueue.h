@@ -2,26 +2,34 @@
 #define ORDERED_QUEUE_H 1
 
 #include <atomic>
-#include <vector>
 #include <chrono>
-#include <thread>
+#include <climits>
 #include <stdexcept>
 #include <cstdio>
 #include <cstdint>
+#include <memory>
+#include <vector>
+#include "internal/futex.h"
 
 /*
  * OrderedQueue - 高性能无锁环形缓冲有序队列(模板化)
  *
- * 特点: 
+ * 特点:
  *  - 支持多生产者并发入队(lock-free CAS)
  *  - 支持单消费者或多消费者顺序出队
  *  - 使用环形缓冲 + slot CAS 避免 map 分配开销
  *  - slot 内存由外部管理, 入队/出队只操作 slot.data_
  *  - 可选丢弃策略: DISCARD_OLDEST / DISCARD_NEWEST / BLOCK / THROW_EXCEPTION
- *  - 支持超时出队
- *  - 提供统计信息: 总入队/出队,timeout,slot 冲突,pending
+ *  - 支持超时出队, dequeue_run 一次取出期望帧起的整段连续就绪帧
+ *  - 空洞策略: 期望帧缺失而后续帧已到达时, 一直等待(HOLD)或超时后跳过(SKIP_AFTER_TIMEOUT)
+ *  - 提供统计信息: 总入队/出队,timeout,slot 冲突,pending,空洞跳过,乱序深度
+ *
+ * 等待策略:
+ *  - BLOCK 入队和带超时的出队都先有限自旋, 再在 slot 状态字上 futex 休眠,
+ *    slot 状态变化时才唤醒, 消费者落后时不再空转占用 CPU;
+ *  - 没有等待者时状态切换不进入系统调用, 快速路径保持无锁.
  *
- * 注意: 
+ * 注意:
  *  - 容量建议为 2 的幂, 方便快速索引计算
  *  - 高乱序入队可能导致 slot 冲突, 需要根据 overflow policy 处理
  */
@@ -37,32 +45,52 @@ public:
         THROW_EXCEPTION  // 抛异常
     };
 
+    // 期望帧缺失(后续帧已到达)时的处理策略
+    enum class GapPolicy {
+        HOLD,               // 一直等待缺失帧, 严格不丢帧
+        SKIP_AFTER_TIMEOUT  // 缺失超过 gap_timeout_ms 后跳过该帧
+    };
+
 private:
-    // 环形缓冲槽
+    // slot 状态, 同时作为 futex 等待字
+    enum SlotState : uint32_t {
+        kEmpty = 0,      // 空闲, 生产者可占用
+        kWriting = 1,    // 生产者写入中
+        kReady = 2,      // 数据就绪, 等待按序取出
+        kReading = 3,    // 消费者取出中
+    };
+
+    // 休眠前的自旋次数, 覆盖"对端马上就写完"的短窗口
+    static constexpr int kSpinCount = 256;
+
+    // 环形缓冲槽, 状态内联在槽内, 访问不再多一次指针跳转
     struct BufferSlot {
-        std::atomic<bool>* filled = nullptr; // true 表示 slot 已被占用
-        uint64_t frame_id{0};            // 当前帧 id
-        T data_;                         // 外部管理的帧数据
-        BufferSlot(){
-            filled = new std::atomic<bool>(false);
-        }
-        ~BufferSlot(){
-            if (filled){
-                delete filled;
-                filled = nullptr;
-            }
-        }
+        std::atomic<uint32_t> state{kEmpty};
+        std::atomic<uint64_t> frame_id{0}; // 当前帧 id(DISCARD_OLDEST 覆盖时可能被并发读取)
+        T data_;                           // 外部管理的帧数据
     };
 
     size_t capacity_;                     // 环形缓冲容量(必须为 2 的幂)
-    std::vector<BufferSlot> ring_buffer_; // 环形缓冲存储
+    std::unique_ptr<BufferSlot[]> ring_buffer_; // 环形缓冲存储
     std::atomic<uint64_t> expected_id_{0}; // 消费者期望的下一个 frame_id
+    std::atomic<uint32_t> waiters_{0};    // 正在 futex 上休眠的线程数
+    std::atomic<uint32_t> window_seq_{0}; // expected_id_ 推进序号, BLOCK 生产者等待窗口时在其上休眠
+    std::atomic<uint64_t> published_end_{0}; // 已发布的最大 frame_id + 1, 用于判断期望帧之后是否已有帧
+
+    // 空洞策略
+    GapPolicy gap_policy_;
+    int64_t gap_timeout_ns_;
+    std::atomic<uint64_t> gap_id_{UINT64_MAX}; // 当前正在计时的缺失帧
+    std::atomic<int64_t> gap_since_ns_{0};     // 该缺失帧开始计时的时间
 
     // 统计信息(避免频繁锁操作)
     alignas(64) std::atomic<uint64_t> total_enqueued_{0};
     alignas(64) std::atomic<uint64_t> total_dequeued_{0};
     alignas(64) std::atomic<uint64_t> timeout_skip_count_{0};
     alignas(64) std::atomic<uint64_t> slot_conflict_count_{0};
+    alignas(64) std::atomic<uint64_t> gap_skip_count_{0};
+    alignas(64) std::atomic<uint64_t> reorder_depth_sum_{0};  // 入队时 frame_id - expected_id_ 之和
+    std::atomic<uint64_t> max_reorder_depth_{0};
 
     // 计算大于等于 n 的最小 2 的幂
     static size_t next_power_of_two(size_t n) {
@@ -79,12 +107,207 @@ private:
         return n + 1;
     }
 
+    BufferSlot& slot_of(uint64_t frame_id) {
+        return ring_buffer_[frame_id & (capacity_ - 1)];
+    }
+
+    // 状态切换后唤醒在该 slot 上休眠的生产者/消费者.
+    // store 与 waiters_ 读取都是 seq_cst, 与 wait_slot_change 中的 "登记 -> 复查" 配对, 不会漏唤醒.
+    void set_state(BufferSlot& slot, uint32_t state) {
+        slot.state.store(state, std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_seq_cst) > 0) {
+            utils::internal::futexWake(slot.state, INT_MAX);
+        }
+    }
+
+    // 等待 slot 状态离开 observed: 先自旋, 再 futex 休眠. deadline 为空表示无限等待, 超时返回 false
+    bool wait_slot_change(BufferSlot& slot, uint32_t observed,
+                          const std::chrono::steady_clock::time_point* deadline) {
+        for (int i = 0; i < kSpinCount; ++i) {
+            if (slot.state.load(std::memory_order_acquire) != observed) return true;
+            utils::internal::cpuRelax();
+        }
+
+        bool changed = true;
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        while (slot.state.load(std::memory_order_seq_cst) == observed) {
+            if (!deadline) {
+                utils::internal::futexWait(slot.state, observed);
+                continue;
+            }
+            const auto left = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                *deadline - std::chrono::steady_clock::now());
+            if (left.count() <= 0) {
+                changed = false;
+                break;
+            }
+            utils::internal::futexWait(slot.state, observed, &left);
+        }
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+        return changed;
+    }
+
+    // BLOCK 模式下等待 frame_id 落入 [expected_id_, expected_id_ + capacity_) 窗口.
+    // 超前的帧提前占住 slot 会挡住同一 slot 上更早的帧, 消费者永远等不到期望帧
+    void wait_window(uint64_t frame_id) {
+        for (int i = 0; i < kSpinCount; ++i) {
+            if (frame_id < expected_id_.load(std::memory_order_acquire) + capacity_) return;
+            utils::internal::cpuRelax();
+        }
+
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        while (true) {
+            const uint32_t seq = window_seq_.load(std::memory_order_seq_cst);
+            if (frame_id < expected_id_.load(std::memory_order_seq_cst) + capacity_) break;
+            utils::internal::futexWait(window_seq_, seq);
+        }
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    static int64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static void atomic_max(std::atomic<uint64_t>& target, uint64_t value,
+                           std::memory_order order = std::memory_order_relaxed) {
+        uint64_t cur = target.load(std::memory_order_relaxed);
+        while (cur < value && !target.compare_exchange_weak(cur, value, order, std::memory_order_relaxed)) {}
+    }
+
+    // expected_id_ 推进后唤醒等待窗口的 BLOCK 生产者
+    void wake_window() {
+        window_seq_.fetch_add(1, std::memory_order_release);
+        utils::internal::futexWake(window_seq_, INT_MAX);
+    }
+
+    /*
+     * 从 id 开始认领连续就绪的帧(READY -> READING), 交给 sink 后一次性推进 expected_id_ 并释放这些 slot.
+     * 认领的 slot 处于 READING, 回绕到同一 slot 时自然停止, 因此一段最长为 capacity_.
+     * 先推进期望 id 再释放槽, 被唤醒的生产者看到的是最新的 expected_id_
+     */
+    template <typename Sink>
+    size_t claim_run(uint64_t id, size_t max_count, Sink&& sink) {
+        size_t n = 0;
+        while (n < max_count) {
+            const uint64_t cur = id + n;
+            BufferSlot& slot = slot_of(cur);
+            uint32_t state = slot.state.load(std::memory_order_acquire);
+            if (state != kReady || slot.frame_id.load(std::memory_order_relaxed) != cur) break;
+            if (!slot.state.compare_exchange_strong(state, kReading, std::memory_order_acq_rel)) break;
+            if (slot.frame_id.load(std::memory_order_relaxed) != cur) {
+                // CAS 之前槽已被覆盖成别的帧
+                set_state(slot, kReady);
+                break;
+            }
+            sink(std::move(slot.data_));
+            ++n;
+        }
+        if (n == 0) return 0;
+
+        // 多消费者时 try_skip_gap 可能已把 expected_id_ 从 id 推到 id + 1, 单次 CAS 会失败并停在那里,
+        // 已取走的 id + 1 .. id + n - 1 随后又被逐个当作空洞等待跳过; 这里推进到至少 id + n
+        atomic_max(expected_id_, id + n, std::memory_order_seq_cst);
+        for (size_t i = 0; i < n; ++i) {
+            slot_of(id + i).state.store(kEmpty, std::memory_order_seq_cst);
+        }
+        if (waiters_.load(std::memory_order_seq_cst) > 0) {
+            wake_window();
+            for (size_t i = 0; i < n; ++i) utils::internal::futexWake(slot_of(id + i).state, INT_MAX);
+        }
+        total_dequeued_.fetch_add(n, std::memory_order_relaxed);
+        return n;
+    }
+
+    // 期望 slot 里残留着已过期的帧(被跳过的帧在跳过之后才写入), 回收该 slot
+    bool drop_stale(uint64_t id) {
+        BufferSlot& slot = slot_of(id);
+        uint32_t state = slot.state.load(std::memory_order_acquire);
+        if (state != kReady || slot.frame_id.load(std::memory_order_relaxed) >= id) return false;
+        if (!slot.state.compare_exchange_strong(state, kReading, std::memory_order_acq_rel)) return false;
+        if (slot.frame_id.load(std::memory_order_relaxed) >= id) {
+            set_state(slot, kReady);
+            return false;
+        }
+        T dropped(std::move(slot.data_));
+        set_state(slot, kEmpty);
+        return true;
+    }
+
+    // SKIP_AFTER_TIMEOUT: 期望帧之后已有帧发布且缺失超过 gap_timeout_ns_ 时跳过期望帧.
+    // 返回 true 表示 expected_id_ 已变化(被本线程或其他消费者推进)
+    bool try_skip_gap(uint64_t id, int64_t now) {
+        if (gap_policy_ != GapPolicy::SKIP_AFTER_TIMEOUT) return false;
+        // 后面没有帧, 只是生产者慢, 不算空洞
+        if (published_end_.load(std::memory_order_acquire) <= id + 1) return false;
+
+        if (gap_id_.load(std::memory_order_relaxed) != id) {
+            gap_since_ns_.store(now, std::memory_order_relaxed);
+            gap_id_.store(id, std::memory_order_relaxed);
+            return false;
+        }
+        if (now - gap_since_ns_.load(std::memory_order_relaxed) < gap_timeout_ns_) return false;
+
+        if (expected_id_.compare_exchange_strong(id, id + 1, std::memory_order_seq_cst)) {
+            gap_skip_count_.fetch_add(1, std::memory_order_relaxed);
+            if (waiters_.load(std::memory_order_seq_cst) > 0) wake_window();
+        }
+        return true;
+    }
+
+    // 顺序出队的公共实现: 取期望帧起的一段, 期望帧未就绪时最多等待 timeout_ms
+    template <typename Sink>
+    size_t drain(size_t max_count, int64_t timeout_ms, Sink&& sink) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+
+        while (true) {
+            const uint64_t id = expected_id_.load(std::memory_order_acquire);
+            const size_t n = claim_run(id, max_count, sink);
+            if (n > 0) return n;
+            if (drop_stale(id)) continue;
+
+            if (try_skip_gap(id, now_ns())) continue;
+            if (timeout_ms <= 0) {
+                return 0;
+            }
+
+            // 后续帧发布不会唤醒期望 slot 上的等待者, 跳帧模式下按 gap 超时分片等待以便重新检查空洞
+            auto wait_until = deadline;
+            if (gap_policy_ == GapPolicy::SKIP_AFTER_TIMEOUT) {
+                const auto slice = std::chrono::steady_clock::now() + std::chrono::nanoseconds(gap_timeout_ns_ > 0 ? gap_timeout_ns_ : 1);
+                if (slice < wait_until) wait_until = slice;
+            }
+            BufferSlot& slot = slot_of(id);
+            const uint32_t state = slot.state.load(std::memory_order_acquire);
+            if (!wait_slot_change(slot, state, &wait_until) && wait_until == deadline) {
+                timeout_skip_count_.fetch_add(1, std::memory_order_relaxed);
+                return 0;
+            }
+        }
+    }
+
+    // 已占有 slot(kWriting), 写入数据并发布; expected 为入队时看到的期望 id, 用于统计乱序深度
+    void publish(BufferSlot& slot, uint64_t frame_id, T&& data, uint64_t expected) {
+        slot.data_ = std::move(data);
+        slot.frame_id.store(frame_id, std::memory_order_relaxed);
+        atomic_max(published_end_, frame_id + 1);
+        set_state(slot, kReady);
+        total_enqueued_.fetch_add(1, std::memory_order_relaxed);
+
+        const uint64_t depth = frame_id - expected;
+        reorder_depth_sum_.fetch_add(depth, std::memory_order_relaxed);
+        atomic_max(max_reorder_depth_, depth);
+    }
+
 public:
     // 构造函数
     // capacity: 环形缓冲大小(最好大于最大乱序跨度)
-    OrderedQueue(size_t capacity) {
+    // gap_policy/gap_timeout_ms: 期望帧缺失时的处理策略, 默认一直等待
+    OrderedQueue(size_t capacity, GapPolicy gap_policy = GapPolicy::HOLD, int64_t gap_timeout_ms = 0)
+        : gap_policy_(gap_policy),
+          gap_timeout_ns_(gap_timeout_ms * 1000000) {
         capacity_ = next_power_of_two(capacity);
-        ring_buffer_.resize(capacity_);
+        ring_buffer_.reset(new BufferSlot[capacity_]);
     }
 
     OrderedQueue(const OrderedQueue&) = delete;
@@ -100,16 +323,25 @@ public:
      * 返回 true 表示成功入队, false 表示被丢弃
      */
     bool enqueue(uint64_t frame_id, T&& data, OverflowPolicy policy = OverflowPolicy::DISCARD_NEWEST) {
-        size_t idx = frame_id & (capacity_ - 1);  // 环形索引计算
+        BufferSlot& slot = slot_of(frame_id);
+
+        while (true) {
+            const uint64_t expected = expected_id_.load(std::memory_order_acquire);
+            if (frame_id < expected) {
+                // 过期数据
+                return false;
+            }
+            if (policy == OverflowPolicy::BLOCK && frame_id >= expected + capacity_) {
+                wait_window(frame_id);
+                continue;
+            }
+
+            uint32_t state = kEmpty;
+            if (slot.state.compare_exchange_strong(state, kWriting, std::memory_order_acq_rel)) {
+                publish(slot, frame_id, std::move(data), expected);
+                return true;
+            }
 
-        bool expected = false;
-        if (frame_id < expected_id_.load(std::memory_order_relaxed)){
-            // 过期数据
-            return false;
-        }
-        while (!ring_buffer_[idx].filled->compare_exchange_weak(
-            expected, true, std::memory_order_acq_rel))
-        {
             // slot 已被占用 -> slot 冲突
             slot_conflict_count_.fetch_add(1, std::memory_order_relaxed);
 
@@ -117,25 +349,27 @@ public:
                 case OverflowPolicy::DISCARD_NEWEST:
                     return false; // 丢弃当前帧
                 case OverflowPolicy::DISCARD_OLDEST:
-                    // 丢弃旧帧, 腾出空间
-                    ring_buffer_[idx].filled->store(false, std::memory_order_release);
-                    expected = false;
+                    // 丢弃旧帧, 腾出空间; 槽中正在读写时稍等再试
+                    if (state == kReady &&
+                        slot.state.compare_exchange_strong(state, kWriting, std::memory_order_acq_rel)) {
+                        if (slot.frame_id.load(std::memory_order_relaxed) > frame_id) {
+                            // 槽里的帧比当前帧新, 被丢弃的应是当前帧
+                            set_state(slot, kReady);
+                            return false;
+                        }
+                        publish(slot, frame_id, std::move(data), expected);
+                        return true;
+                    }
+                    utils::internal::cpuRelax();
                     break;
                 case OverflowPolicy::BLOCK:
-                    // 阻塞等待 slot 释放
-                    std::this_thread::sleep_for(std::chrono::microseconds(1));
-                    expected = false;
+                    // 已在窗口内, 占用者只可能是正在被取走的旧帧, 等待 slot 释放
+                    wait_slot_change(slot, state, nullptr);
                     break;
                 case OverflowPolicy::THROW_EXCEPTION:
                     throw std::runtime_error("OrderedQueue slot conflict");
             }
         }
-
-        // 写入数据
-        ring_buffer_[idx].data_ = std::move(data);
-        ring_buffer_[idx].frame_id = frame_id;
-        total_enqueued_.fetch_add(1, std::memory_order_relaxed);
-        return true;
     }
 
     /*
@@ -144,39 +378,20 @@ public:
      * timeout_ms: 超时毫秒, 0 表示非阻塞立即返回
      */
     bool try_dequeue(T& data_out, int64_t timeout_ms = 0) {
-        auto start = std::chrono::steady_clock::now();
-        std::chrono::milliseconds timeout(timeout_ms);
-
-        while (true) {
-            uint64_t id = expected_id_.load(std::memory_order_relaxed);
-            size_t idx = id & (capacity_ - 1);
-
-            // 如果 slot 已到达期望帧
-            if (ring_buffer_[idx].filled->load(std::memory_order_acquire) &&
-                ring_buffer_[idx].frame_id == id)
-            {
-                data_out = std::move(ring_buffer_[idx].data_);
-                ring_buffer_[idx].frame_id = 0;
-                ring_buffer_[idx].filled->store(false, std::memory_order_release);
-
-                // 更新期望 id
-                expected_id_.compare_exchange_strong(id, id + 1, std::memory_order_release);
-                total_dequeued_.fetch_add(1, std::memory_order_relaxed);
-                return true;
-            }
-
-            if (timeout_ms > 0) {
-                auto elapsed = std::chrono::steady_clock::now() - start;
-                if (elapsed >= timeout) {
-                    timeout_skip_count_.fetch_add(1, std::memory_order_relaxed);
-                    return false;
-                }
-            } else {
-                return false;
-            }
+        return drain(1, timeout_ms, [&data_out](T&& data) { data_out = std::move(data); }) == 1;
+    }
 
-            std::this_thread::sleep_for(std::chrono::microseconds(5));
-        }
+    /*
+     * dequeue_run - 取出从 expected_id 开始的整段连续就绪帧, 追加到 out
+     * 乱序完成的多个 worker 一起交付时, 一次调用即可取走整段, 只推进一次 expected_id
+     * max_count: 本次最多取出的帧数
+     * timeout_ms: 期望帧未就绪时的等待毫秒, 0 表示非阻塞
+     * 返回取出的帧数
+     */
+    size_t dequeue_run(std::vector<T>& out, size_t max_count = SIZE_MAX, int64_t timeout_ms = 0) {
+        // 预留空间, 认领 slot 后 push_back 不会因扩容失败而把 slot 卡在 READING
+        out.reserve(out.size() + (max_count < capacity_ ? max_count : capacity_));
+        return drain(max_count, timeout_ms, [&out](T&& data) { out.push_back(std::move(data)); });
     }
 
     // ===================== 查询接口 =====================
@@ -198,7 +413,10 @@ public:
         uint64_t total_dequeued;
         uint64_t timeout_skip;
         uint64_t slot_conflict;
+        uint64_t gap_skip;
         uint64_t pending;
+        uint64_t max_reorder_depth;
+        double avg_reorder_depth;
         double timeout_rate;
         double conflict_rate;
     };
@@ -209,11 +427,15 @@ public:
         stats.total_dequeued = total_dequeued_.load(std::memory_order_relaxed);
         stats.timeout_skip = timeout_skip_count_.load(std::memory_order_relaxed);
         stats.slot_conflict = slot_conflict_count_.load(std::memory_order_relaxed);
+        stats.gap_skip = gap_skip_count_.load(std::memory_order_relaxed);
+        stats.max_reorder_depth = max_reorder_depth_.load(std::memory_order_relaxed);
+        stats.avg_reorder_depth = stats.total_enqueued > 0 ?
+            (double)reorder_depth_sum_.load(std::memory_order_relaxed) / stats.total_enqueued : 0.0;
 
         // 精确 pending 统计
         size_t pending_count = 0;
-        for (const auto& slot : ring_buffer_)
-            if (slot.filled->load(std::memory_order_relaxed)) ++pending_count;
+        for (size_t i = 0; i < capacity_; ++i)
+            if (ring_buffer_[i].state.load(std::memory_order_relaxed) == kReady) ++pending_count;
         stats.pending = pending_count;
 
         stats.timeout_rate = stats.total_dequeued > 0 ?
@@ -233,6 +455,9 @@ public:
                stats.timeout_skip, stats.timeout_rate*100);
         printf("Slot conflict:  %lu (%.2f%%)\n",
                stats.slot_conflict, stats.conflict_rate*100);
+        printf("Gap skip:       %lu\n", stats.gap_skip);
+        printf("Reorder depth:  avg %.2f, max %lu\n",
+               stats.avg_reorder_depth, stats.max_reorder_depth);
         printf("===================================\n\n");
     }
 
@@ -241,6 +466,9 @@ public:
         total_dequeued_.store(0, std::memory_order_relaxed);
         timeout_skip_count_.store(0, std::memory_order_relaxed);
         slot_conflict_count_.store(0, std::memory_order_relaxed);
+        gap_skip_count_.store(0, std::memory_order_relaxed);
+        reorder_depth_sum_.store(0, std::memory_order_relaxed);
+        max_reorder_depth_.store(0, std::memory_order_relaxed);
     }
 };
 
@@ -129,6 +129,7 @@ struct RgaProcessorConfig {
     int srcFormat = RK_FORMAT_YCbCr_420_SP;      // 源格式
     int poolSize = 4;                            // 缓冲池大小
     int threadAffinity = -1;                     // 线程亲和性(-1表示不设置)
+    std::vector<int> workerAffinity;             // 线程池工作线程可运行的核心(空表示不设置)
     int maxPendingTasks = 30;                    // 最大挂起任务数
     
     /**
@@ -8,6 +8,8 @@
 #define SAFE_QUEUE_H
 
 /* 使用vector作为底层存储 循环队列 */
+#include <atomic>
+#include <stdexcept>
 #include <vector>
 #include <mutex>
 #include <condition_variable>
@@ -1,6 +1,8 @@
 #ifndef SIMPLE_VARIANT_H
 #define SIMPLE_VARIANT_H
 
+#include <cstddef>
+#include <new>
 #include <type_traits>
 #include <stdexcept>
 #include <utility>
@@ -33,89 +35,151 @@ struct HasDuplicates<First, Rest...> : std::conditional_t<
     HasDuplicates<Rest...>
 > {};
 
+// 类型在列表中的下标(调用方保证存在)
+template <typename T, typename... Rest>
+struct IndexOf;
 
-// 递归存储
-template <typename TFirst, typename... TRest>
-struct VariantStorage {
-    TFirst first;
-    VariantStorage<TRest...> rest;
-};
-// 递归展开的中止特化
-template <typename TLast>
-struct VariantStorage<TLast> {
-    TLast first;
-};
+template <typename T, typename... Rest>
+struct IndexOf<T, T, Rest...> : std::integral_constant<int, 0> {};
+
+template <typename T, typename First, typename... Rest>
+struct IndexOf<T, First, Rest...> : std::integral_constant<int, 1 + IndexOf<T, Rest...>::value> {};
 
+/*
+ * SimpleVariant - 只保存当前一个值的 variant
+ * 存储为所有类型共用的对齐缓冲区(大小/对齐取最大者), 按 typeIndex_ 构造/析构/拷贝当前值.
+ * get<T>() 要求当前保存的正是 T, 否则抛出 std::runtime_error.
+ */
 template <typename... Types>
 class SimpleVariant {
 private:
+    static_assert(sizeof...(Types) > 0, "SimpleVariant requires at least one type");
     static_assert(!HasDuplicates<Types...>::value, "SimpleVariant does not allow duplicate types");
 
-    using Storage = VariantStorage<Types...>;
+    using Storage = typename std::aligned_union<0, Types...>::type;
+
+    // 所有类型的移动构造都不抛异常时, SimpleVariant 的移动构造才标记 noexcept
+    using AllNothrowMove = std::is_same<
+        std::integer_sequence<bool, std::is_nothrow_move_constructible<Types>::value...>,
+        std::integer_sequence<bool, (sizeof(Types) > 0)...>>;
+
+    template <typename T>
+    using EnableIfMember = typename std::enable_if<IsIn<typename std::decay<T>::type, Types...>::value, int>::type;
+
     Storage storage_;
     int typeIndex_ = -1;
 
 public:
     SimpleVariant() = default;
 
-    template <typename T>
-    SimpleVariant(T val) {
-        set(val);
+    template <typename T, EnableIfMember<T> = 0>
+    SimpleVariant(T&& val) {
+        emplace(std::forward<T>(val));
     }
 
-    template <typename T>
-    void set(T val) {
-        typeIndex_ = assign<T, Types...>(val, &storage_);
+    SimpleVariant(const SimpleVariant& other) {
+        if (other.typeIndex_ >= 0) {
+            copyAt(other.typeIndex_, &storage_, &other.storage_);
+            typeIndex_ = other.typeIndex_;
+        }
+    }
+
+    SimpleVariant(SimpleVariant&& other) noexcept(AllNothrowMove::value) {
+        if (other.typeIndex_ >= 0) {
+            moveAt(other.typeIndex_, &storage_, &other.storage_);
+            typeIndex_ = other.typeIndex_;
+        }
+    }
+
+    SimpleVariant& operator=(const SimpleVariant& other) {
+        if (this != &other) {
+            reset();
+            if (other.typeIndex_ >= 0) {
+                copyAt(other.typeIndex_, &storage_, &other.storage_);
+                typeIndex_ = other.typeIndex_;
+            }
+        }
+        return *this;
+    }
+
+    SimpleVariant& operator=(SimpleVariant&& other) {
+        if (this != &other) {
+            reset();
+            if (other.typeIndex_ >= 0) {
+                moveAt(other.typeIndex_, &storage_, &other.storage_);
+                typeIndex_ = other.typeIndex_;
+            }
+        }
+        return *this;
+    }
+
+    ~SimpleVariant() { reset(); }
+
+    template <typename T, EnableIfMember<T> = 0>
+    void set(T&& val) {
+        reset();
+        emplace(std::forward<T>(val));
     }
 
     template <typename T>
     T get() const {
-        return getImpl<T, Types...>(&storage_);
+        static_assert(IsIn<T, Types...>::value, "Type not in variant");
+        if (typeIndex_ != IndexOf<T, Types...>::value) {
+            throw std::runtime_error("SimpleVariant holds a different type");
+        }
+        return *reinterpret_cast<const T*>(&storage_);
+    }
+
+    template <typename T>
+    bool holds() const {
+        static_assert(IsIn<T, Types...>::value, "Type not in variant");
+        return typeIndex_ == IndexOf<T, Types...>::value;
     }
 
     int index() const { return typeIndex_; }
 
-private:
-    // assign递归
-    template <typename T, typename TFirst, typename... TRest>
-    int assign(T val, VariantStorage<TFirst, TRest...>* s, int currentIndex = 0) {
-        if (std::is_same<T, TFirst>::value) {
-            s->first = val;
-            return currentIndex;
-        } else {
-            return assign<T, TRest...>(val, &s->rest, currentIndex + 1);
+    // 析构当前值, 回到空状态
+    void reset() {
+        if (typeIndex_ >= 0) {
+            destroyAt(typeIndex_, &storage_);
+            typeIndex_ = -1;
         }
     }
 
-    // assign终止条件(最后一个类型)
-    template <typename T, typename TLast>
-    int assign(T val, VariantStorage<TLast>* s, int currentIndex = 0) {
-        if (std::is_same<T, TLast>::value) {
-            s->first = val;
-            return currentIndex;
-        } else {
-            throw std::runtime_error("Type not in variant");
-        }
+private:
+    template <typename T>
+    void emplace(T&& val) {
+        using U = typename std::decay<T>::type;
+        ::new (static_cast<void*>(&storage_)) U(std::forward<T>(val));
+        typeIndex_ = IndexOf<U, Types...>::value;
     }
 
-    // getImpl递归
-    template <typename T, typename TFirst, typename... TRest>
-    T getImpl(const VariantStorage<TFirst, TRest...>* s) const {
-        if (std::is_same<T, TFirst>::value) {
-            return s->first;
-        } else {
-            return getImpl<T, TRest...>(&s->rest);
-        }
+    // 按下标分派的构造/析构表, 每种类型一个函数
+    template <typename T>
+    static void destroyImpl(void* p) { static_cast<T*>(p)->~T(); }
+
+    template <typename T>
+    static void copyImpl(void* dst, const void* src) { ::new (dst) T(*static_cast<const T*>(src)); }
+
+    template <typename T>
+    static void moveImpl(void* dst, void* src) { ::new (dst) T(std::move(*static_cast<T*>(src))); }
+
+    static void destroyAt(int index, void* p) {
+        using Fn = void (*)(void*);
+        static const Fn table[] = {&destroyImpl<Types>...};
+        table[index](p);
     }
 
-    // getImpl终止条件
-    template <typename T, typename TLast>
-    T getImpl(const VariantStorage<TLast>* s) const {
-        if (std::is_same<T, TLast>::value) {
-            return s->first;
-        } else {
-            throw std::runtime_error("Type not in variant");
-        }
+    static void copyAt(int index, void* dst, const void* src) {
+        using Fn = void (*)(void*, const void*);
+        static const Fn table[] = {&copyImpl<Types>...};
+        table[index](dst, src);
+    }
+
+    static void moveAt(int index, void* dst, void* src) {
+        using Fn = void (*)(void*, void*);
+        static const Fn table[] = {&moveImpl<Types>...};
+        table[index](dst, src);
     }
 };
 
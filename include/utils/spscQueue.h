@@ -0,0 +1,266 @@
+/*
+ * @FilePath: /include/utils/spscQueue.h
+ * @Author: SweerItTer xxxzhou.xian@gmail.com
+ * @Date: 2026-03-04
+ * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
+ * @Description: 单生产者单消费者环形队列, 用于严格 1:1 的流水线边
+ */
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+/* 采集线程 -> RGA 调度, 编码器 -> StreamWriter 这类边只有一个生产者和一个消费者,
+ * 不需要 SafeQueue 的互斥锁, 也不需要 MPMC 队列的 CAS:
+ * 1. head_/tail_ 各自只有一个写者, 推进只需一次 release store(wait-free);
+ * 2. 双方缓存对端索引, 只有缓存显示满/空时才读对端的 cache line;
+ * 3. 容量向上取整为 2 的幂, 下标用掩码计算;
+ * 4. 批量 push/pop 一次发布多个元素;
+ * 5. 可选阻塞模式: 队列空/满时基于 futex 休眠, 仅在对端确实在休眠时才发起系统调用.
+ *    非阻塞模式下热路径不做任何额外同步.
+ */
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include "internal/futex.h"
+
+template <typename T>
+class SpscQueue {
+public:
+    /**
+     * @param capacity 最小容量, 实际容量向上取整为 2 的幂
+     * @param blocking 是否启用阻塞 push/pop(否则只能使用 try_* 接口)
+     */
+    explicit SpscQueue(size_t capacity, bool blocking = false)
+        : blocking_(blocking) {
+        if (capacity == 0) throw std::invalid_argument("SpscQueue capacity must be > 0");
+        size_t cap = 1;
+        while (cap < capacity) cap <<= 1;
+        capacity_ = cap;
+        mask_ = cap - 1;
+        buffer_.reset(new T[cap]);
+    }
+
+    // 禁止拷贝和移动: 两端线程直接持有队列引用
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    ~SpscQueue() { close(); }
+
+    size_t capacity() const { return capacity_; }
+    bool isBlocking() const { return blocking_; }
+
+    // 近似大小, 任一端调用都可以
+    size_t size_approx() const {
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        const size_t head = head_.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    bool empty() const { return size_approx() == 0; }
+
+    // ----------------- 生产者端 -----------------
+    // 队列满返回 false, 不改动 item
+    bool try_push(T&& item) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cachedHead_ == capacity_) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            if (tail - cachedHead_ == capacity_) return false;
+        }
+        buffer_[tail & mask_] = std::move(item);
+        publishTail(tail + 1);
+        return true;
+    }
+
+    bool try_push(const T& item) {
+        T copy(item);
+        return try_push(std::move(copy));
+    }
+
+    // 批量入队, 一次发布, 返回实际入队数量(items 中前 n 个被移走)
+    size_t try_push_bulk(T* items, size_t count) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t free = capacity_ - (tail - cachedHead_);
+        if (free < count) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            free = capacity_ - (tail - cachedHead_);
+        }
+        const size_t n = count < free ? count : free;
+        if (n == 0) return 0;
+        for (size_t i = 0; i < n; ++i) buffer_[(tail + i) & mask_] = std::move(items[i]);
+        publishTail(tail + n);
+        return n;
+    }
+
+    // 阻塞入队(需 blocking 模式), 队列关闭返回 false
+    bool push(T&& item) {
+        requireBlocking();
+        for (;;) {
+            if (closed_.load(std::memory_order_acquire)) return false;
+            if (try_push(std::move(item))) return true;
+            // 休眠前记下序号, 唤醒条件在此之后发生的变化不会被漏掉
+            const uint32_t seq = spaceSeq_.load(std::memory_order_acquire);
+            producerWaiting_.store(1, std::memory_order_seq_cst);
+            if (tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_seq_cst) < capacity_ ||
+                closed_.load(std::memory_order_acquire)) {
+                producerWaiting_.store(0, std::memory_order_relaxed);
+                continue;
+            }
+            utils::internal::futexWait(spaceSeq_, seq);
+            producerWaiting_.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // ----------------- 消费者端 -----------------
+    bool try_pop(T& item) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cachedTail_) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            if (head == cachedTail_) return false;
+        }
+        item = std::move(buffer_[head & mask_]);
+        publishHead(head + 1);
+        return true;
+    }
+
+    // 批量出队, 返回实际出队数量
+    size_t try_pop_bulk(T* out, size_t maxCount) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        size_t avail = cachedTail_ - head;
+        if (avail < maxCount) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            avail = cachedTail_ - head;
+        }
+        const size_t n = maxCount < avail ? maxCount : avail;
+        if (n == 0) return 0;
+        for (size_t i = 0; i < n; ++i) out[i] = std::move(buffer_[(head + i) & mask_]);
+        publishHead(head + n);
+        return n;
+    }
+
+    // 阻塞出队(需 blocking 模式), 队列关闭且已取空时返回 false
+    bool pop(T& item) {
+        return popUntil(item, nullptr);
+    }
+
+    // 带超时的阻塞出队, 超时/关闭返回 false
+    template <class Rep, class Period>
+    bool pop(T& item, const std::chrono::duration<Rep, Period>& timeout) {
+        const auto deadline = std::chrono::steady_clock::now() +
+                              std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout);
+        return popUntil(item, &deadline);
+    }
+
+    // 关闭队列: 唤醒两端, 之后 push 失败, pop 取完剩余元素后失败
+    void close() {
+        closed_.store(true, std::memory_order_seq_cst);
+        if (!blocking_) return;
+        dataSeq_.fetch_add(1, std::memory_order_release);
+        futexWake(dataSeq_);
+        spaceSeq_.fetch_add(1, std::memory_order_release);
+        futexWake(spaceSeq_);
+    }
+
+    bool isClosed() const { return closed_.load(std::memory_order_acquire); }
+
+private:
+    static constexpr size_t kCacheLine = 64;
+
+    void requireBlocking() const {
+        if (!blocking_) throw std::logic_error("SpscQueue: blocking push/pop requires blocking mode");
+    }
+
+    // 阻塞模式下发布需要 seq_cst, 与对端"登记等待 -> 复查索引"配对, 避免漏唤醒.
+    // 唤醒方用 exchange 清掉等待标记, 对端被调度之前的后续发布不再重复进入系统调用.
+    void publishTail(size_t tail) {
+        if (!blocking_) {
+            tail_.store(tail, std::memory_order_release);
+            return;
+        }
+        tail_.store(tail, std::memory_order_seq_cst);
+        if (consumerWaiting_.load(std::memory_order_seq_cst) &&
+            consumerWaiting_.exchange(0, std::memory_order_seq_cst)) {
+            dataSeq_.fetch_add(1, std::memory_order_release);
+            futexWake(dataSeq_);
+        }
+    }
+
+    void publishHead(size_t head) {
+        if (!blocking_) {
+            head_.store(head, std::memory_order_release);
+            return;
+        }
+        head_.store(head, std::memory_order_seq_cst);
+        if (producerWaiting_.load(std::memory_order_seq_cst) &&
+            producerWaiting_.exchange(0, std::memory_order_seq_cst)) {
+            spaceSeq_.fetch_add(1, std::memory_order_release);
+            futexWake(spaceSeq_);
+        }
+    }
+
+    bool popUntil(T& item, const std::chrono::steady_clock::time_point* deadline) {
+        requireBlocking();
+        for (;;) {
+            if (try_pop(item)) return true;
+            if (closed_.load(std::memory_order_acquire)) {
+                // 关闭前已发布的元素仍要取完
+                return try_pop(item);
+            }
+
+            const uint32_t seq = dataSeq_.load(std::memory_order_acquire);
+            consumerWaiting_.store(1, std::memory_order_seq_cst);
+            if (tail_.load(std::memory_order_seq_cst) != head_.load(std::memory_order_relaxed) ||
+                closed_.load(std::memory_order_acquire)) {
+                consumerWaiting_.store(0, std::memory_order_relaxed);
+                continue;
+            }
+
+            if (deadline) {
+                const auto left = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    *deadline - std::chrono::steady_clock::now());
+                if (left.count() <= 0) {
+                    consumerWaiting_.store(0, std::memory_order_relaxed);
+                    return try_pop(item);
+                }
+                utils::internal::futexWait(dataSeq_, seq, &left);
+            } else {
+                utils::internal::futexWait(dataSeq_, seq);
+            }
+            consumerWaiting_.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // 每个方向最多一个等待者
+    static void futexWake(std::atomic<uint32_t>& word) {
+        utils::internal::futexWake(word, 1);
+    }
+
+    // 对象只保证 alignof(size_t) 对齐(堆上通常 16 字节), 成员无法落在固定的 cache line 上;
+    // 改为在两组字段前后各留一整条 cache line, 无论起始地址如何两组都不会共享同一行,
+    // 也不会与对象前后的其他数据共享. 不用 alignas, 避免 C++14 下对齐 new 的问题.
+    char frontPad_[kCacheLine];
+
+    // 消费者写的字段
+    std::atomic<size_t> head_{0};
+    size_t cachedTail_ = 0;                 // 消费者缓存的 tail_
+    std::atomic<uint32_t> consumerWaiting_{0};
+    std::atomic<uint32_t> dataSeq_{0};      // 生产者发布后递增, 消费者在其上 futex 等待
+    char consumerPad_[kCacheLine];
+
+    // 生产者写的字段
+    std::atomic<size_t> tail_{0};
+    size_t cachedHead_ = 0;                 // 生产者缓存的 head_
+    std::atomic<uint32_t> producerWaiting_{0};
+    std::atomic<uint32_t> spaceSeq_{0};     // 消费者取走后递增, 生产者在其上 futex 等待
+    char producerPad_[kCacheLine];
+
+    std::unique_ptr<T[]> buffer_;
+    size_t capacity_ = 0;
+    size_t mask_ = 0;
+    std::atomic<bool> closed_{false};
+    bool blocking_;
+};
+
+#endif // SPSC_QUEUE_H
@@ -8,8 +8,14 @@
 
 #include <chrono>
 #include <iostream>
+#include <cstdio>
+#include <string>
 #include <pthread.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
 #include <thread>
+#include <unistd.h>
+#include <vector>
 
 class ThreadUtils {
 public:
@@ -49,6 +55,28 @@ public:
         } 
         return false;
     }
+    // 绑定当前线程到一组CPU核心(如 big.LITTLE 只用大核), 越界核号被忽略
+    static bool bindCurrentThreadToCores(const std::vector<int>& cores) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        int valid = 0;
+        for (int core : cores) {
+            if (core < 0 || core >= CPU_SETSIZE) continue;
+            CPU_SET(core, &cpuset);
+            ++valid;
+        }
+        if (valid == 0) return false;
+        return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) == 0;
+    }
+    // 设置当前线程 nice 值(-20 ~ 19), Linux 上 nice 按线程生效
+    static bool setCurrentThreadNice(int nice) {
+        const id_t tid = static_cast<id_t>(syscall(SYS_gettid));
+        return setpriority(PRIO_PROCESS, tid, nice) == 0;
+    }
+    // 设置当前线程名, 内核限制 15 个字符, 超出部分截断
+    static bool setCurrentThreadName(const std::string& name) {
+        return pthread_setname_np(pthread_self(), name.substr(0, 15).c_str()) == 0;
+    }
     // 绑定线程到指定CPU核心
     static void bindThreadToCore(std::thread& thread, int core) {
         cpu_set_t cpuset;
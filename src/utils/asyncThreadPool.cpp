@@ -6,8 +6,70 @@
  */
 #include "asyncThreadPool.h"
 #include "logger_v2.h"
+#include "threadUtils.h"
 #include <iostream>
 #include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace {
+// 本地队列容量, 超出部分回退到全局注入队列
+constexpr std::size_t kLocalDequeCapacity = 256;
+// 每处理 N 个任务先检查一次全局队列, 避免本地任务持续产生时饿死外部投递
+constexpr uint64_t kGlobalPollInterval = 61;
+// 防饿死: 每 N 次取任务让 Normal 先于 High, 每 M 次让 Background 最先
+constexpr uint64_t kNormalBoostInterval = 8;
+constexpr uint64_t kBackgroundBoostInterval = 32;
+// 本地队列空时一次从全局 Normal 通道批量取走的最大任务数
+constexpr std::size_t kBulkDequeueMax = 16;
+
+inline int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline uint32_t nextRandom(uint32_t& state) {
+    // xorshift32, 只用于挑选窃取起点
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// 单写者计数器: 只有 owner 线程写入, 避免原子 RMW
+inline void bumpCounter(std::atomic<uint64_t>& c, uint64_t n = 1) {
+    c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+} // namespace
+
+/**
+ * @brief 工作线程槽位, 数量固定为 maxThreads_, 线程退出后槽位可被新线程复用
+ */
+struct asyncThreadPool::WorkerSlot {
+    WorkerSlot(asyncThreadPool* o, size_t i) : owner(o), index(i), deque(kLocalDequeCapacity) {}
+
+    // deque 的 top_/bottom_ 按缓存行对齐, C++14 的全局 new 不保证 64 字节对齐, 这里按类型对齐分配
+    static void* operator new(std::size_t size) {
+        void* p = nullptr;
+        if (posix_memalign(&p, alignof(WorkerSlot), size) != 0) throw std::bad_alloc();
+        return p;
+    }
+    static void operator delete(void* p) noexcept { std::free(p); }
+
+    asyncThreadPool* owner;
+    size_t index;
+    bool inUse = false;                                     // 受 workersMtx_ 保护
+    utils::internal::WorkStealingDeque<TaskNode> deque;
+
+    // 统计计数, 只由当前占用槽位的工作线程写入
+    std::atomic<uint64_t> executed{0};
+    std::atomic<uint64_t> stolen{0};
+    std::atomic<uint64_t> parks{0};
+    std::atomic<uint64_t> bulkDequeues{0};
+    std::atomic<uint64_t> bulkDequeuedTasks{0};
+    std::atomic<uint64_t> expired{0};
+    std::atomic<uint64_t> cancelled{0};
+};
 
 /**
  * @brief 封装线程信息
@@ -15,76 +77,452 @@
 struct asyncThreadPool::WorkerWrapper {
     std::thread thread;
     std::atomic<bool> stopFlag{false};
-    std::chrono::steady_clock::time_point lastActiveTime;
+    std::atomic<int64_t> lastActiveNs{0};                   // steady_clock 纳秒, manager 无锁读取
+    WorkerSlot* slot = nullptr;
+
+    void touch() { lastActiveNs.store(steadyNowNs(), std::memory_order_relaxed); }
 };
 
+/**
+ * @brief 任务级直方图, 由 setInstrumentation 开关
+ */
+struct asyncThreadPool::Instrumentation {
+    utils::internal::LogLinearHistogram waitNs;
+    utils::internal::LogLinearHistogram execNs;
+    utils::internal::LogLinearHistogram queueDepth;
+};
+
+thread_local asyncThreadPool::WorkerSlot* asyncThreadPool::currentSlot_ = nullptr;
+
 // ---------------- 构造/析构 ----------------
 asyncThreadPool::asyncThreadPool(std::size_t minThreads, std::size_t maxThreads, std::size_t maxQueueSize)
-    : running_(true), minThreads_(minThreads), maxThreads_(maxThreads), maxQueueSize_(maxQueueSize)
+    : asyncThreadPool(minThreads, maxThreads, maxQueueSize, ScalingPolicy())
 {
-    if(minThreads_ <= 0) minThreads_ = 1;
-    if(maxThreads_ < minThreads_) maxThreads_ = static_cast<size_t>(std::thread::hardware_concurrency());
+}
+
+asyncThreadPool::asyncThreadPool(std::size_t minThreads, std::size_t maxThreads, std::size_t maxQueueSize,
+                                 const ScalingPolicy& policy)
+    : asyncThreadPool(minThreads, maxThreads, maxQueueSize, policy, PlacementPolicy())
+{
+}
+
+asyncThreadPool::asyncThreadPool(std::size_t minThreads, std::size_t maxThreads, std::size_t maxQueueSize,
+                                 const ScalingPolicy& policy, const PlacementPolicy& placement)
+    : running_(true), instr_(new Instrumentation()),
+      maxQueueSize_(maxQueueSize), policy_(policy), placement_(placement),
+      minThreads_(minThreads), maxThreads_(maxThreads)
+{
+    if(policy_.checkInterval.count() <= 0) policy_.checkInterval = MANAGERINTERVAL;
+
+    // size_t(-1) 表示未指定
+    if(minThreads_ == 0 || minThreads_ == static_cast<size_t>(-1)) minThreads_ = 1;
+    if(maxThreads_ < minThreads_ || maxThreads_ == static_cast<size_t>(-1))
+        maxThreads_ = std::max<size_t>(minThreads_, std::thread::hardware_concurrency());
+
+    // 槽位一次性分配, 窃取时无需对槽位数组加锁
+    slots_.reserve(maxThreads_);
+    for(size_t i = 0; i < maxThreads_; ++i){
+        slots_.emplace_back(new WorkerSlot(this, i));
+    }
 
     // 启动最小线程数
-    for(size_t i = 0; i < minThreads_; ++i){
-        auto wrapper = std::make_shared<WorkerWrapper>();
-        workers_.push_back(wrapper);
-        wrapper->thread = std::thread([this, wrapper]{ worker(wrapper); });
+    {
+        std::lock_guard<std::mutex> lock(workersMtx_);
+        for(size_t i = 0; i < minThreads_; ++i){
+            auto wrapper = std::make_shared<WorkerWrapper>();
+            wrapper->slot = claimSlot();
+            wrapper->touch();
+            workers_.push_back(wrapper);
+            wrapper->thread = std::thread([this, wrapper]{ worker(wrapper); });
+        }
+        liveWorkers_.store(workers_.size(), std::memory_order_relaxed);
     }
 
     // 启动管理线程
-    managerThread_ = std::thread([this]{ managerThreadFunc(); });
+    managerThread_ = std::thread([this]{
+        if (!placement_.threadName.empty()) ThreadUtils::setCurrentThreadName(placement_.threadName + "-mgr");
+        managerThreadFunc();
+    });
 }
 
 asyncThreadPool::~asyncThreadPool() {
     stop();
+    // stop 之后仍可能有并发 submit 漏进来的任务, 析构时再清理一次
+    drainTasks();
+}
+
+// ----------------- 入队 -----------------
+size_t asyncThreadPool::admissionLimit(Priority priority) const {
+    // High 独占 maxQueueSize/8 的预留名额, 队列被批量任务占满时帧转换仍能入队
+    const size_t highReserve = maxQueueSize_ / 8;
+    switch (priority) {
+    case Priority::High:       return maxQueueSize_;
+    case Priority::Normal:     return maxQueueSize_ - highReserve;
+    case Priority::Background: return std::max<size_t>(1, maxQueueSize_ / 2);
+    }
+    return maxQueueSize_;
+}
+
+size_t asyncThreadPool::acquireQueueSlots(Priority priority, size_t want, bool block) {
+    const size_t limit = admissionLimit(priority);
+    // 一次 CAS 尽量预留 want 个名额, 不足时取剩余可用部分
+    auto tryReserve = [this, limit, want]() -> size_t {
+        size_t cur = pendingTasks_.load(std::memory_order_relaxed);
+        while (cur < limit) {
+            const size_t take = std::min(want, limit - cur);
+            if (pendingTasks_.compare_exchange_weak(cur, cur + take,
+                                                    std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed)) {
+                return take;
+            }
+        }
+        return 0;
+    };
+
+    if (want == 0 || !running_.load(std::memory_order_acquire)) return 0;
+    size_t reserved = tryReserve();
+    if (reserved > 0 || !block) return reserved;
+
+    // 慢路径: 队列满, 等待 worker 出队后唤醒
+    std::unique_lock<std::mutex> lock(notFullMtx_);
+    blockedProducers_.fetch_add(1, std::memory_order_seq_cst);
+    queueNotFullCv_.wait(lock, [&] {
+        if (!running_.load(std::memory_order_acquire)) return true;
+        reserved = tryReserve();
+        return reserved > 0;
+    });
+    blockedProducers_.fetch_sub(1, std::memory_order_relaxed);
+    return reserved;
+}
+
+bool asyncThreadPool::acquireQueueSlot(Priority priority, bool block) {
+    return acquireQueueSlots(priority, 1, block) == 1;
+}
+
+void asyncThreadPool::releaseQueueSlot() {
+    releaseQueueSlots(1);
+}
+
+void asyncThreadPool::releaseQueueSlots(size_t count) {
+    pendingTasks_.fetch_sub(count, std::memory_order_seq_cst);
+    if (blockedProducers_.load(std::memory_order_seq_cst) > 0) {
+        // 各优先级上限不同, notify_one 可能唤醒仍无法入队的低优先级生产者
+        std::lock_guard<std::mutex> lock(notFullMtx_);
+        queueNotFullCv_.notify_all();
+    }
+}
+
+asyncThreadPool::TaskNode* asyncThreadPool::acquireNode(Priority priority, bool block) {
+    static_assert(sizeof(TaskNode) <= utils::internal::SmallBlockPool::kMaxBytes,
+                  "TaskNode must fit in a SmallBlockPool size class");
+    static_assert(sizeof(TaskNode) <= 2 * utils::internal::SmallBlockPool::kGranularity,
+                  "TaskNode should stay within two cache lines");
+    static_assert(sizeof(TaskCallback) <= TaskNode::kInlineBytes,
+                  "TaskCallback must fit in TaskNode inline storage");
+    if (!acquireQueueSlot(priority, block)) return nullptr;
+    try {
+        return allocNode();
+    } catch(...) {
+        releaseQueueSlot();
+        throw;
+    }
+}
+
+asyncThreadPool::TaskNode* asyncThreadPool::allocNode() {
+    return ::new (utils::internal::SmallBlockPool::allocate(sizeof(TaskNode))) TaskNode();
+}
+
+void asyncThreadPool::applyOptions(TaskNode* node, const TaskOptions& options) {
+    if (options.deadline != std::chrono::steady_clock::time_point::max()) {
+        // 0 保留给"无截止时间"
+        node->deadlineNs = std::max<int64_t>(1, std::chrono::duration_cast<std::chrono::nanoseconds>(
+            options.deadline.time_since_epoch()).count());
+    }
+    node->cancel = CancellationToken::retain(options.token.state_);
+}
+
+void asyncThreadPool::releaseNode(TaskNode* node) {
+    CancellationToken::release(node->cancel);
+    utils::internal::SmallBlockPool::deallocate(node, sizeof(TaskNode));
+}
+
+void asyncThreadPool::abandonNode(TaskNode* node) {
+    releaseNode(node);
+    releaseQueueSlot();
+}
+
+void asyncThreadPool::stampNodes(TaskNode** nodes, size_t count) {
+    const bool instrumented = instrumented_.load(std::memory_order_relaxed);
+    // 等待时间触发扩容同样依赖入队时刻
+    if (!instrumented && policy_.waitThreshold.count() <= 0) return;
+    const int64_t now = steadyNowNs();
+    for (size_t i = 0; i < count; ++i) nodes[i]->enqueueNs = now;
+    if (instrumented) instr_->queueDepth.record(pendingTasks_.load(std::memory_order_relaxed));
+}
+
+void asyncThreadPool::checkBacklog() {
+    if (policy_.backlogPerThread == 0) return;
+    const size_t threads = liveWorkers_.load(std::memory_order_relaxed);
+    if (threads >= maxThreads_) return;
+    if (pendingTasks_.load(std::memory_order_relaxed) > threads * policy_.backlogPerThread) {
+        requestScale();
+    }
+}
+
+void asyncThreadPool::requestScale() {
+    // 先读后写: 请求已挂起时不再做 RMW, 避免热路径上的缓存行争用
+    if (scaleRequested_.load(std::memory_order_relaxed)) return;
+    if (scaleRequested_.exchange(true, std::memory_order_acq_rel)) return;
+    std::lock_guard<std::mutex> lock(managerMtx_);
+    managerCv_.notify_one();
+}
+
+void asyncThreadPool::dispatchNode(TaskNode* node, Priority priority) {
+    stampNodes(&node, 1);
+
+    // 工作线程内部投递的 Normal 任务: 直接压入自己的本地队列, 不经过任何全局结构
+    // High/Background 走各自的全局通道, 以便所有线程按优先级统一出队
+    WorkerSlot* local = currentSlot_;
+    const bool pushedLocal = priority == Priority::Normal &&
+                             local && local->owner == this && local->deque.push(node);
+    if (!pushedLocal) {
+        injectQueues_[static_cast<size_t>(priority)].enqueue(node);
+    }
+
+    wakeWorker();
+    checkBacklog();
+}
+
+void asyncThreadPool::dispatchNodes(TaskNode** nodes, size_t count, Priority priority) {
+    stampNodes(nodes, count);
+
+    size_t first = 0;
+    WorkerSlot* local = currentSlot_;
+    if (priority == Priority::Normal && local && local->owner == this) {
+        while (first < count && local->deque.push(nodes[first])) ++first;
+    }
+    if (first < count) {
+        injectQueues_[static_cast<size_t>(priority)].enqueue_bulk(nodes + first, count - first);
+    }
+
+    bulkSubmits_.fetch_add(1, std::memory_order_relaxed);
+    bulkSubmittedTasks_.fetch_add(count, std::memory_order_relaxed);
+    wakeWorkers(count);
+    checkBacklog();
+}
+
+void asyncThreadPool::wakeWorker() {
+    wakeWorkers(1);
+}
+
+void asyncThreadPool::wakeWorkers(size_t count) {
+    // 与 parkWorker 中 sleepers_ 自增构成 Dekker 式配对: 要么 worker 看到新任务, 要么这里看到休眠者
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_relaxed) == 0) return;
+
+    std::lock_guard<std::mutex> lock(parkMtx_);
+    const size_t sleeping = sleepers_.load(std::memory_order_relaxed);
+    if (sleeping == 0) return;
+    if (count >= sleeping) {
+        parkCv_.notify_all();
+        count = sleeping;
+    } else {
+        for (size_t i = 0; i < count; ++i) parkCv_.notify_one();
+    }
+    wakeRounds_.fetch_add(1, std::memory_order_relaxed);
+    wokenWorkers_.fetch_add(count, std::memory_order_relaxed);
 }
 
 // ----------------- worker -----------------
+asyncThreadPool::TaskNode* asyncThreadPool::findTask(WorkerSlot& slot, uint32_t& rng, uint64_t tick) {
+    TaskNode* node = nullptr;
+    auto& high = injectQueues_[static_cast<size_t>(Priority::High)];
+    auto& normal = injectQueues_[static_cast<size_t>(Priority::Normal)];
+    auto& background = injectQueues_[static_cast<size_t>(Priority::Background)];
+
+    // 防饿死: 周期性让低优先级通道先出队
+    if (tick % kBackgroundBoostInterval == 0 && background.try_dequeue(node)) return node;
+    const bool normalBoost = (tick % kNormalBoostInterval == 0);
+    if (!normalBoost && high.try_dequeue(node)) return node;
+
+    if (tick % kGlobalPollInterval == 0 && normal.try_dequeue(node)) return node;
+    if ((node = slot.deque.pop()) != nullptr) return node;
+
+    // 本地队列已空: 从全局 Normal 通道批量取, 第一个直接执行, 其余压入本地队列供自己和 thief 消费
+    const size_t room = slot.deque.capacity() - slot.deque.sizeApprox();
+    TaskNode* grabbed[kBulkDequeueMax];
+    const size_t got = normal.try_dequeue_bulk(grabbed, std::min(kBulkDequeueMax, room));
+    if (got > 0) {
+        // 逆序压入, 使 owner 按原顺序 pop
+        for (size_t i = got - 1; i > 0; --i) {
+            if (!slot.deque.push(grabbed[i])) normal.enqueue(grabbed[i]);
+        }
+        if (got > 1) {
+            bumpCounter(slot.bulkDequeues);
+            bumpCounter(slot.bulkDequeuedTasks, got);
+            wakeWorkers(got - 1);
+        }
+        return grabbed[0];
+    }
+
+    if (normalBoost && high.try_dequeue(node)) return node;
+
+    // 随机起点轮询其他槽位, 分散 thief 之间的竞争
+    const size_t count = slots_.size();
+    const size_t start = nextRandom(rng) % count;
+    for (size_t i = 0; i < count; ++i) {
+        WorkerSlot& victim = *slots_[(start + i) % count];
+        if (&victim == &slot || victim.deque.emptyApprox()) continue;
+        if ((node = victim.deque.steal()) != nullptr) {
+            bumpCounter(slot.stolen);
+            return node;
+        }
+    }
+
+    if (background.try_dequeue(node)) return node;
+    return nullptr;
+}
+
+void asyncThreadPool::parkWorker(const WorkerWrapper& wrapper) {
+    std::unique_lock<std::mutex> lock(parkMtx_);
+    sleepers_.fetch_add(1, std::memory_order_seq_cst);
+    parkCv_.wait(lock, [this, &wrapper] {
+        return !running_.load(std::memory_order_relaxed) ||
+               wrapper.stopFlag.load(std::memory_order_relaxed) ||
+               pendingTasks_.load(std::memory_order_seq_cst) > 0;
+    });
+    sleepers_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void asyncThreadPool::runNode(WorkerSlot& slot, TaskNode* node) {
+    // 出队时才检查: 排队期间过期或被取消的任务不再占用线程时间
+    if (node->cancel && node->cancel->cancelled.load(std::memory_order_acquire)) {
+        node->drop(node);
+        bumpCounter(slot.cancelled);
+        return;
+    }
+    if (node->deadlineNs != 0 && steadyNowNs() > node->deadlineNs) {
+        node->drop(node);
+        bumpCounter(slot.expired);
+        return;
+    }
+
+    // enqueueNs 为 0 表示入队时未开启统计
+    const int64_t enqueueNs = node->enqueueNs;
+    const bool instrumented = enqueueNs != 0 && instrumented_.load(std::memory_order_relaxed);
+    int64_t startNs = 0;
+    if (enqueueNs != 0) {
+        startNs = steadyNowNs();
+        const int64_t waitNs = std::max<int64_t>(0, startNs - enqueueNs);
+        if (instrumented) instr_->waitNs.record(static_cast<uint64_t>(waitNs));
+        if (policy_.waitThreshold.count() > 0 &&
+            waitNs > std::chrono::duration_cast<std::chrono::nanoseconds>(policy_.waitThreshold).count() &&
+            liveWorkers_.load(std::memory_order_relaxed) < maxThreads_) {
+            requestScale();
+        }
+    }
+
+    try { node->run(node); }
+    catch(...){ LOG_ERROR("[ThreadPool] Task exception\n"); }
+
+    bumpCounter(slot.executed);
+
+    if (instrumented) {
+        instr_->execNs.record(static_cast<uint64_t>(steadyNowNs() - startNs));
+    }
+}
+
 void asyncThreadPool::worker(std::weak_ptr<WorkerWrapper> wrapperWeak) {
     auto wrapper = wrapperWeak.lock();
     if (!wrapper) return;
 
-    {
-        std::lock_guard<std::mutex> lock(queueMtx_);
-        wrapper->lastActiveTime = std::chrono::steady_clock::now();
-    }
+    WorkerSlot& slot = *wrapper->slot;
+    currentSlot_ = &slot;
+    applyPlacement(slot);
+    wrapper->touch();
+
+    uint32_t rng = static_cast<uint32_t>(slot.index + 1) * 2654435761u;
+    uint64_t tick = 0;
 
     while (running_.load(std::memory_order_relaxed) && !wrapper->stopFlag.load(std::memory_order_relaxed)) {
-        TaskCallback task;
-        {
-            std::unique_lock<std::mutex> lock(queueMtx_);
-            workerCv_.wait(lock, [this, &wrapper] {
-                return !running_.load(std::memory_order_relaxed) ||
-                       wrapper->stopFlag.load(std::memory_order_relaxed) ||
-                       tasks_.size_approx() > 0;
-            });
-            if (!running_.load(std::memory_order_relaxed) || wrapper->stopFlag.load(std::memory_order_relaxed)) break;
-            if (!tasks_.try_dequeue(task)) continue;
-            wrapper->lastActiveTime = std::chrono::steady_clock::now();
+        TaskNode* node = findTask(slot, rng, ++tick);
+        if (!node) {
+            bumpCounter(slot.parks);
+            parkWorker(*wrapper);
+            continue;
         }
+        releaseQueueSlot();
+        wrapper->touch();
 
         activeTasks_.fetch_add(1, std::memory_order_relaxed);
-        try { task(); }
-        catch(...){ LOG_ERROR("[ThreadPool] Task exception\n"); }
+        runNode(slot, node);
         activeTasks_.fetch_sub(1, std::memory_order_relaxed);
 
-        queueNotFullCv_.notify_one();
+        releaseNode(node);
+    }
+
+    // 缩容退出: 本地剩余任务交还全局队列, 由其他线程继续执行
+    currentSlot_ = nullptr;
+    bool handedOff = false;
+    while (TaskNode* left = slot.deque.pop()) {
+        injectQueues_[static_cast<size_t>(Priority::Normal)].enqueue(left);
+        handedOff = true;
+    }
+    if (handedOff) wakeWorker();
+}
+
+void asyncThreadPool::applyPlacement(const WorkerSlot& slot) {
+    const PlacementPolicy& p = placement_;
+    if (!p.threadName.empty()) {
+        ThreadUtils::setCurrentThreadName(p.threadName + "-" + std::to_string(slot.index));
+    }
+
+    if (!p.cpus.empty()) {
+        // 按槽位而不是线程序号分配核心, 缩容后复用槽位的新线程仍落在同一个核上
+        const bool ok = p.pinEachWorker
+            ? ThreadUtils::bindCurrentThreadToCores({p.cpus[slot.index % p.cpus.size()]})
+            : ThreadUtils::bindCurrentThreadToCores(p.cpus);
+        if (!ok) LOG_WARN("[ThreadPool] worker %zu: failed to set cpu affinity\n", slot.index);
+    }
+
+    if (p.realtimePriority > 0) {
+        ThreadUtils::setRealtimeThread(pthread_self(), p.realtimePriority);
+    } else if (p.niceValue != 0) {
+        if (!ThreadUtils::setCurrentThreadNice(p.niceValue)) {
+            LOG_WARN("[ThreadPool] worker %zu: failed to set nice %d\n", slot.index, p.niceValue);
+        }
     }
 }
 
 // ----------------- manager -----------------
 void asyncThreadPool::managerThreadFunc() {
+    std::unique_lock<std::mutex> lock(managerMtx_);
     while (running_) {
-        std::this_thread::sleep_for(MANAGERINTERVAL);
+        // 平时按 checkInterval 兜底检查, 提交路径发现 backlog/等待超阈值时被立即唤醒
+        managerCv_.wait_for(lock, policy_.checkInterval, [this] {
+            return !running_.load(std::memory_order_relaxed) ||
+                   scaleRequested_.load(std::memory_order_relaxed);
+        });
         if (!running_) break;
+        scaleRequested_.store(false, std::memory_order_relaxed);
+
+        lock.unlock();
         adjustThreads();
+        lock.lock();
     }
 }
 
-void asyncThreadPool::adjustThreads() {
-    static constexpr auto kIdleThreshold = std::chrono::seconds(2);
+asyncThreadPool::WorkerSlot* asyncThreadPool::claimSlot() {
+    for (auto& s : slots_) {
+        if (!s->inUse) {
+            s->inUse = true;
+            return s.get();
+        }
+    }
+    return nullptr;
+}
 
+void asyncThreadPool::adjustThreads() {
     // 只有 manager 调用
     // 重复使用避免反复申请内存
     thread_local std::vector<std::shared_ptr<WorkerWrapper>> toStart;
@@ -95,17 +533,19 @@ void asyncThreadPool::adjustThreads() {
     toStop.clear();
     idleCandidates.clear();
 
-    const auto now = std::chrono::steady_clock::now();
+    const int64_t nowNs = steadyNowNs();
+    const int64_t idleThresholdNs = std::chrono::duration_cast<std::chrono::nanoseconds>(policy_.idleTimeout).count();
+    const int64_t scaleDownDelayNs = std::chrono::duration_cast<std::chrono::nanoseconds>(policy_.scaleDownDelay).count();
 
-    auto idleFor = [now](const std::shared_ptr<WorkerWrapper>& w) {
-        return now - w->lastActiveTime;
+    auto idleFor = [nowNs](const std::shared_ptr<WorkerWrapper>& w) {
+        return nowNs - w->lastActiveNs.load(std::memory_order_relaxed);
     };
 
     {
-        std::lock_guard<std::mutex> lock(queueMtx_);
+        std::lock_guard<std::mutex> lock(workersMtx_);
 
         // 当前待处理任务数量
-        const uint64_t backlog = static_cast<uint64_t>(tasks_.size_approx());
+        const uint64_t backlog = static_cast<uint64_t>(pendingTasks_.load(std::memory_order_relaxed));
         // 当前处理中任务数量
         const uint64_t active = static_cast<uint64_t>(activeTasks_.load(std::memory_order_relaxed));
         // 任务总数
@@ -122,77 +562,105 @@ void asyncThreadPool::adjustThreads() {
             const size_t addCount = desiredWorkers - totalWorkers;
             toStart.reserve(addCount);
             for (size_t i = 0; i < addCount; ++i) {
+                WorkerSlot* slot = claimSlot();
+                if (!slot) break;
                 auto wrapper = std::make_shared<WorkerWrapper>();
-                wrapper->lastActiveTime = now;
+                wrapper->slot = slot;
+                wrapper->lastActiveNs.store(nowNs, std::memory_order_relaxed);
                 workers_.push_back(wrapper);
                 toStart.push_back(std::move(wrapper));
             }
         }
 
-        // 缩容
-        if (desiredWorkers < totalWorkers && totalWorkers > minThreads_) {
+        // 缩容(滞回): 低负载持续 scaleDownDelay 后才回收, 避免突发间隙里反复扩缩
+        const bool lowLoad = desiredWorkers < totalWorkers && totalWorkers > minThreads_ &&
+                             (demand * 2 <= totalWorkers);
+        if (!lowLoad) {
+            lowLoadSinceNs_ = 0;
+        } else if (lowLoadSinceNs_ == 0) {
+            lowLoadSinceNs_ = nowNs;
+        }
+        if (lowLoad && nowNs - lowLoadSinceNs_ >= scaleDownDelayNs) {
             // 取前50%休眠线程
-            const bool lowLoad = (demand * 2 <= totalWorkers);
-            if (lowLoad) {
-                const size_t maxRemovable = totalWorkers - minThreads_;
-                const size_t wantRemove = std::min(totalWorkers - desiredWorkers, maxRemovable);
-
-                if (wantRemove > 0) {
-                    idleCandidates.reserve(totalWorkers);
-                    for (const auto& w : workers_) {
-                        if (!w->stopFlag.load(std::memory_order_relaxed) && idleFor(w) > kIdleThreshold) {
-                            idleCandidates.push_back(w);
-                        }
+            const size_t maxRemovable = totalWorkers - minThreads_;
+            const size_t wantRemove = std::min(totalWorkers - desiredWorkers, maxRemovable);
+
+            if (wantRemove > 0) {
+                idleCandidates.reserve(totalWorkers);
+                for (const auto& w : workers_) {
+                    if (!w->stopFlag.load(std::memory_order_relaxed) && idleFor(w) > idleThresholdNs) {
+                        idleCandidates.push_back(w);
+                    }
+                }
+
+                if (!idleCandidates.empty()) {
+                    const size_t willRemove = std::min(wantRemove, idleCandidates.size());
+
+                    if (willRemove < idleCandidates.size()) {
+                        std::nth_element(
+                            idleCandidates.begin(),
+                            idleCandidates.begin() + static_cast<std::ptrdiff_t>(willRemove),
+                            idleCandidates.end(),
+                            [&](const auto& a, const auto& b) { return idleFor(a) > idleFor(b); });
+                    } else {
+                        std::sort(
+                            idleCandidates.begin(),
+                            idleCandidates.end(),
+                            [&](const auto& a, const auto& b) { return idleFor(a) > idleFor(b); });
                     }
 
-                    if (!idleCandidates.empty()) {
-                        const size_t willRemove = std::min(wantRemove, idleCandidates.size());
-
-                        if (willRemove < idleCandidates.size()) {
-                            std::nth_element(
-                                idleCandidates.begin(),
-                                idleCandidates.begin() + static_cast<std::ptrdiff_t>(willRemove),
-                                idleCandidates.end(),
-                                [&](const auto& a, const auto& b) { return idleFor(a) > idleFor(b); });
-                        } else {
-                            std::sort(
-                                idleCandidates.begin(),
-                                idleCandidates.end(),
-                                [&](const auto& a, const auto& b) { return idleFor(a) > idleFor(b); });
-                        }
-
-                        toStop.reserve(willRemove);
-                        for (size_t i = 0; i < willRemove; ++i) {
-                            auto& w = idleCandidates[i];
-                            if (w->stopFlag.exchange(true, std::memory_order_relaxed)) continue;
-                            toStop.push_back(w);
-                        }
-
-                        if (!toStop.empty()) {
-                            workers_.erase(
-                                std::remove_if(workers_.begin(), workers_.end(),
-                                    [](const auto& w) { return w->stopFlag.load(std::memory_order_relaxed); }),
-                                workers_.end());
-                        }
+                    toStop.reserve(willRemove);
+                    for (size_t i = 0; i < willRemove; ++i) {
+                        auto& w = idleCandidates[i];
+                        if (w->stopFlag.exchange(true, std::memory_order_relaxed)) continue;
+                        toStop.push_back(w);
+                    }
+
+                    if (!toStop.empty()) {
+                        workers_.erase(
+                            std::remove_if(workers_.begin(), workers_.end(),
+                                [](const auto& w) { return w->stopFlag.load(std::memory_order_relaxed); }),
+                            workers_.end());
+                        lowLoadSinceNs_ = 0;
                     }
                 }
             }
         }
+
+        liveWorkers_.store(workers_.size(), std::memory_order_relaxed);
+    }
+
+    if (!toStop.empty()) {
+        { std::lock_guard<std::mutex> lock(parkMtx_); }
+        parkCv_.notify_all();
     }
 
-    if (!toStop.empty()) workerCv_.notify_all();
-    
     for (auto& w : toStop) {
         if (w->thread.joinable()) w->thread.join();
     }
-    
+
+    // 线程已退出且本地队列已交还, 槽位可以复用
+    if (!toStop.empty()) {
+        std::lock_guard<std::mutex> lock(workersMtx_);
+        for (auto& w : toStop) w->slot->inUse = false;
+    }
+
     for (auto& w : toStart) {
         w->thread = std::thread([this, w] { worker(w); });
-    }   
+    }
+
+    if (!toStart.empty() || !toStop.empty()) {
+        threadsAdded_.fetch_add(toStart.size(), std::memory_order_relaxed);
+        threadsRemoved_.fetch_add(toStop.size(), std::memory_order_relaxed);
+        LOG_DEBUG("[ThreadPool] scale +%zu -%zu (pending=%zu active=%zu)\n",
+                  toStart.size(), toStop.size(),
+                  pendingTasks_.load(std::memory_order_relaxed),
+                  activeTasks_.load(std::memory_order_relaxed));
+    }
 }
 
 size_t asyncThreadPool::aliveThreadCount() const {
-    std::lock_guard<std::mutex> lock(queueMtx_);
+    std::lock_guard<std::mutex> lock(workersMtx_);
     size_t count = 0;
     for (const auto& w : workers_) {
         if (w && !w->stopFlag.load(std::memory_order_relaxed)) count++;
@@ -200,19 +668,91 @@ size_t asyncThreadPool::aliveThreadCount() const {
     return count;
 }
 
+asyncThreadPool::PoolStats asyncThreadPool::getPoolStats() const {
+    PoolStats stats{};
+    stats.aliveThreads = aliveThreadCount();
+    stats.pendingTasks = pendingTasks_.load(std::memory_order_relaxed);
+    stats.activeTasks = activeTasks_.load(std::memory_order_relaxed);
+    for (const auto& s : slots_) {
+        stats.executedTasks += s->executed.load(std::memory_order_relaxed);
+        stats.stolenTasks += s->stolen.load(std::memory_order_relaxed);
+        stats.parks += s->parks.load(std::memory_order_relaxed);
+        stats.bulkDequeues += s->bulkDequeues.load(std::memory_order_relaxed);
+        stats.bulkDequeuedTasks += s->bulkDequeuedTasks.load(std::memory_order_relaxed);
+        stats.expiredTasks += s->expired.load(std::memory_order_relaxed);
+        stats.cancelledTasks += s->cancelled.load(std::memory_order_relaxed);
+    }
+    stats.bulkSubmits = bulkSubmits_.load(std::memory_order_relaxed);
+    stats.bulkSubmittedTasks = bulkSubmittedTasks_.load(std::memory_order_relaxed);
+    stats.wakeRounds = wakeRounds_.load(std::memory_order_relaxed);
+    stats.wokenWorkers = wokenWorkers_.load(std::memory_order_relaxed);
+    stats.threadsAdded = threadsAdded_.load(std::memory_order_relaxed);
+    stats.threadsRemoved = threadsRemoved_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// ----------------- 任务级统计 -----------------
+void asyncThreadPool::setInstrumentation(bool enabled) {
+    instrumented_.store(enabled, std::memory_order_relaxed);
+}
+
+bool asyncThreadPool::instrumentationEnabled() const {
+    return instrumented_.load(std::memory_order_relaxed);
+}
+
+asyncThreadPool::InstrumentationSnapshot asyncThreadPool::getInstrumentation() const {
+    InstrumentationSnapshot snap;
+    snap.waitNs = instr_->waitNs.snapshot();
+    snap.execNs = instr_->execNs.snapshot();
+    snap.queueDepth = instr_->queueDepth.snapshot();
+    return snap;
+}
+
+void asyncThreadPool::resetInstrumentation() {
+    instr_->waitNs.reset();
+    instr_->execNs.reset();
+    instr_->queueDepth.reset();
+}
+
 // ----------------- 停止线程池 -----------------
+void asyncThreadPool::drainTasks() {
+    TaskNode* node = nullptr;
+    auto discard = [](TaskNode* n) {
+        n->drop(n);
+        releaseNode(n);
+    };
+    for (auto& q : injectQueues_) {
+        while (q.try_dequeue(node)) discard(node);
+    }
+    for (auto& s : slots_) {
+        while ((node = s->deque.steal()) != nullptr) discard(node);
+    }
+    pendingTasks_.store(0, std::memory_order_relaxed);
+}
+
 void asyncThreadPool::stop() {
     if(!running_.exchange(false)) return;
-    workerCv_.notify_all();
+    { std::lock_guard<std::mutex> lock(managerMtx_); }
+    managerCv_.notify_all();
+    { std::lock_guard<std::mutex> lock(parkMtx_); }
+    parkCv_.notify_all();
+    { std::lock_guard<std::mutex> lock(notFullMtx_); }
     queueNotFullCv_.notify_all();
     // 停止管理线程
     if(managerThread_.joinable())
         managerThread_.join();
 
     // 停止工作线程
-    for(auto &w : workers_){
+    std::vector<std::shared_ptr<WorkerWrapper>> workers;
+    {
+        std::lock_guard<std::mutex> lock(workersMtx_);
+        workers.swap(workers_);
+    }
+    for(auto &w : workers){
         w->stopFlag = true;
         if(w->thread.joinable()) w->thread.join();
     }
-    workers_.clear();
+
+    // 未执行的任务直接丢弃, 对应 future 会得到 broken_promise
+    drainTasks();
 }
@@ -0,0 +1,84 @@
+/*
+ * @FilePath: /src/utils/net/bodyStream.cpp
+ * @Author: SweerItTer xxxzhou.xian@gmail.com
+ * @Date: 2026-03-15
+ * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
+ * @Description: Bounded chunk queue backing streamed response bodies
+ */
+
+#include "net/bodyStream.h"
+
+namespace utils {
+namespace net {
+
+bool BodyStream::write(std::string chunk) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    writable_.wait(lock, [this] { return buffered_ < maxBuffered_ || cancelled_ || aborted_ || closed_; });
+    if (cancelled_ || aborted_ || closed_) return false;
+    if (chunk.empty()) return true; // 空分块在 chunked 编码中表示结束, 不能透传
+
+    buffered_ += chunk.size();
+    chunks_.push_back(std::move(chunk));
+    notifyReady();
+    return true;
+}
+
+void BodyStream::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closed_ || aborted_) return;
+    closed_ = true;
+    notifyReady();
+    writable_.notify_all();
+}
+
+void BodyStream::abort() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closed_ || aborted_) return;
+    aborted_ = true;
+    notifyReady();
+    writable_.notify_all();
+}
+
+bool BodyStream::cancelled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cancelled_;
+}
+
+void BodyStream::setReadyCallback(std::function<void()> onReady) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!cancelled_) onReady_ = std::move(onReady);
+}
+
+BodyStream::ReadStatus BodyStream::read(std::deque<std::string>& out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (aborted_) return ReadStatus::ABORTED;
+    if (!chunks_.empty()) {
+        out.swap(chunks_);
+        chunks_.clear();
+        buffered_ = 0;
+        writable_.notify_all();
+        return ReadStatus::DATA;
+    }
+    if (closed_) return ReadStatus::END;
+    waiting_ = true;
+    return ReadStatus::WAIT;
+}
+
+void BodyStream::cancel() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cancelled_ = true;
+    onReady_ = nullptr;
+    chunks_.clear();
+    buffered_ = 0;
+    writable_.notify_all();
+}
+
+// 持锁调用: 与 cancel() 互斥, 保证回调不会在连接销毁后执行
+void BodyStream::notifyReady() {
+    if (!waiting_ || !onReady_) return;
+    waiting_ = false;
+    onReady_();
+}
+
+} // namespace net
+} // namespace utils
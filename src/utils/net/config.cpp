@@ -131,6 +131,9 @@ bool loadRuntimeConfig(const std::string& configPath, RuntimeConfig& outConfig,
         applyServerNumber(*serverObject, "io_threads", [&](int value) {
             config.server.ioThreads = static_cast<uint32_t>(value);
         });
+        applyServerBool(*serverObject, "reuse_port", [&](bool value) {
+            config.server.reusePort = value;
+        });
         applyServerNumber(*serverObject, "worker_threads_min", [&](int value) {
             config.server.workerThreadsMin = static_cast<uint32_t>(value);
         });
@@ -143,6 +146,15 @@ bool loadRuntimeConfig(const std::string& configPath, RuntimeConfig& outConfig,
         applyServerNumber(*serverObject, "idle_timeout_sec", [&](int value) {
             config.server.idleTimeoutSec = value;
         });
+        applyServerNumber(*serverObject, "request_header_timeout_sec", [&](int value) {
+            config.server.requestHeaderTimeoutSec = value;
+        });
+        applyServerNumber(*serverObject, "request_body_timeout_sec", [&](int value) {
+            config.server.requestBodyTimeoutSec = value;
+        });
+        applyServerNumber(*serverObject, "max_pipelined_requests", [&](int value) {
+            config.server.maxPipelinedRequests = static_cast<uint32_t>(value);
+        });
         applyServerBool(*serverObject, "enable_tcp_keepalive", [&](bool value) {
             config.server.enableTcpKeepAlive = value;
         });
@@ -211,8 +223,13 @@ bool loadRuntimeConfig(const std::string& configPath, RuntimeConfig& outConfig,
             return false;
         }
         RouteConfig routeConfig;
-        if (!readStringField(entry, "method", routeConfig.method, error)) return false;
-        if (!readStringField(entry, "path", routeConfig.path, error)) return false;
+        if (entry.find("mount")) {
+            if (!readStringField(entry, "mount", routeConfig.path, error)) return false;
+            routeConfig.mount = true;
+        } else {
+            if (!readStringField(entry, "method", routeConfig.method, error)) return false;
+            if (!readStringField(entry, "path", routeConfig.path, error)) return false;
+        }
         if (!readStringField(entry, "plugin", routeConfig.pluginName, error)) return false;
         if (!readStringField(entry, "handler", routeConfig.handlerName, error)) return false;
         routeConfig.method = toUpper(routeConfig.method);
@@ -155,7 +155,12 @@ bool ConfiguredServer::build(std::string& error) {
         }
 
         auto handler = handlerIt->second;
-        if (!server_->http().on(route.method, route.path, std::move(handler))) {
+        if (route.mount) {
+            if (!server_->http().mount(route.path, std::move(handler))) {
+                error = "Failed to mount route prefix '" + route.path + "'";
+                return false;
+            }
+        } else if (!server_->http().on(route.method, route.path, std::move(handler))) {
             error = "Failed to register route '" + route.method + " " + route.path + "'";
             return false;
         }
@@ -30,10 +30,40 @@ static std::string toHeaderLines(const std::unordered_map<std::string, std::stri
     return oss.str();
 }
 
+static inline unsigned char asciiLower(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c + ('a' - 'A')) : c;
+}
+
+size_t HeaderNameHash::operator()(const std::string& name) const {
+    // FNV-1a, 逐字节转小写
+    uint64_t h = 14695981039346656037ull;
+    for (const char ch : name) {
+        h ^= asciiLower(static_cast<unsigned char>(ch));
+        h *= 1099511628211ull;
+    }
+    return static_cast<size_t>(h);
+}
+
+bool HeaderNameEqual::operator()(const std::string& a, const std::string& b) const {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (asciiLower(static_cast<unsigned char>(a[i])) != asciiLower(static_cast<unsigned char>(b[i]))) return false;
+    }
+    return true;
+}
+
 std::string HttpRequest::path() const {
     return stripQueryString(target);
 }
 
+const std::string& HttpRequest::param(const std::string& name) const {
+    static const std::string empty;
+    for (const auto& entry : params) {
+        if (entry.first == name) return entry.second;
+    }
+    return empty;
+}
+
 bool HttpRequest::parseJsonBody(JsonValue& outValue, std::string& error) const {
     return JsonValue::parse(body, outValue, error);
 }
@@ -54,7 +84,13 @@ Response HttpResponse::toResponse() {
 
     std::unordered_map<std::string, std::string> headers = headers_;
     headers.emplace("Server", "utilsCore-net");
-    headers["Content-Length"] = std::to_string(contentLength);
+    if (body_.kind == Body::Kind::STREAM) {
+        headers.erase("Content-Length");
+        headers["Transfer-Encoding"] = "chunked";
+        body_.stream.chunked = true;
+    } else {
+        headers["Content-Length"] = std::to_string(contentLength);
+    }
     if (headers.find("Content-Type") == headers.end()) {
         headers["Content-Type"] = "application/octet-stream";
     }
@@ -0,0 +1,282 @@
+/*
+ * @FilePath: /src/utils/net/httpParser.cpp
+ * @Author: SweerItTer xxxzhou.xian@gmail.com
+ * @Date: 2026-03-11
+ * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
+ * @Description: Resumable HTTP/1.1 request parser implementation
+ */
+
+#include "net/httpParser.h"
+
+#include <cstring>
+
+namespace utils {
+namespace net {
+
+namespace {
+
+inline bool isBlank(char c) { return c == ' ' || c == '\t'; }
+
+inline char asciiLower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+// 与全小写字面量做大小写不敏感比较
+bool equalsLower(const char* s, size_t len, const char* lower) {
+    for (size_t i = 0; i < len; ++i) {
+        if (lower[i] == '\0' || asciiLower(s[i]) != lower[i]) return false;
+    }
+    return lower[len] == '\0';
+}
+
+// 最后一个 transfer-coding 是否为 chunked, 例如 "gzip, chunked"
+bool endsWithChunked(const char* s, size_t len) {
+    size_t begin = len;
+    while (begin > 0 && s[begin - 1] != ',') --begin;
+    while (begin < len && isBlank(s[begin])) ++begin;
+    return equalsLower(s + begin, len - begin, "chunked");
+}
+
+inline int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    const char lower = asciiLower(c);
+    if (lower >= 'a' && lower <= 'f') return lower - 'a' + 10;
+    return -1;
+}
+
+constexpr size_t kMaxChunkLine = 4096; // 块长度行 (含 chunk-ext) 上限
+
+} // namespace
+
+void HttpRequestParser::reset() {
+    state_ = State::REQUEST_LINE;
+    lineStart_ = 0;
+    scanned_ = 0;
+    bodyStart_ = 0;
+    contentLength_ = 0;
+    hasContentLength_ = false;
+    chunked_ = false;
+    chunkLeft_ = 0;
+    sectionStart_ = 0;
+    requestEnd_ = 0;
+    error_ = nullptr;
+    method_ = Span{};
+    target_ = Span{};
+    version_ = Span{};
+    headers_.clear();
+    chunks_.clear();
+}
+
+HttpRequestParser::Status HttpRequestParser::fail(const char* reason) {
+    state_ = State::FAILED;
+    error_ = reason;
+    return Status::ERROR;
+}
+
+HttpRequestParser::Status HttpRequestParser::parse(const char* data, size_t len, HttpRequest& out) {
+    if (state_ == State::FAILED) return Status::ERROR;
+
+    while (true) {
+        if (state_ == State::BODY) {
+            if (len - bodyStart_ < contentLength_) return Status::NEED_MORE;
+            consumed_ = bodyStart_ + static_cast<size_t>(contentLength_);
+            break;
+        }
+        if (state_ == State::CHUNK_DATA) {
+            if (len - lineStart_ < chunkLeft_) return Status::NEED_MORE;
+            chunks_.push_back(Span{lineStart_, static_cast<size_t>(chunkLeft_)});
+            lineStart_ += static_cast<size_t>(chunkLeft_);
+            scanned_ = lineStart_;
+            state_ = State::CHUNK_END;
+            continue;
+        }
+
+        const void* nl = (scanned_ < len) ? std::memchr(data + scanned_, '\n', len - scanned_) : nullptr;
+        const size_t reach = nl ? static_cast<size_t>(static_cast<const char*>(nl) - data) + 1 : len;
+        if (state_ == State::REQUEST_LINE || state_ == State::HEADERS) {
+            if (reach > limits_.maxHeaderBytes) return fail("header section too large");
+        } else if (state_ == State::TRAILERS) {
+            if (reach - sectionStart_ > limits_.maxHeaderBytes) return fail("trailer section too large");
+        } else if (reach - lineStart_ > kMaxChunkLine) {
+            return fail("chunk size line too long");
+        }
+        if (!nl) {
+            scanned_ = len;
+            return Status::NEED_MORE;
+        }
+
+        size_t end = reach - 1;
+        if (end > lineStart_ && data[end - 1] == '\r') --end;
+        if (!onLine(data, lineStart_, end, reach)) return Status::ERROR;
+        lineStart_ = reach;
+        scanned_ = reach;
+        if (requestEnd_ != 0) {
+            consumed_ = requestEnd_;
+            break;
+        }
+    }
+
+    emit(data, out);
+    reset();
+    return Status::COMPLETE;
+}
+
+bool HttpRequestParser::onLine(const char* data, size_t begin, size_t end, size_t next) {
+    switch (state_) {
+    case State::REQUEST_LINE:
+        // 请求行前的空行按 RFC 7230 忽略
+        if (end == begin) return true;
+        if (!parseRequestLine(data, begin, end)) {
+            fail("malformed request line");
+            return false;
+        }
+        state_ = State::HEADERS;
+        return true;
+
+    case State::HEADERS:
+        if (end != begin) {
+            if (parseHeaderLine(data, begin, end)) return true;
+            fail("malformed header");
+            return false;
+        }
+        if (chunked_ && hasContentLength_) {
+            fail("both Content-Length and Transfer-Encoding");
+            return false;
+        }
+        bodyStart_ = next;
+        if (chunked_) contentLength_ = 0; // 改为累计解码后的长度
+        state_ = chunked_ ? State::CHUNK_SIZE : State::BODY;
+        return true;
+
+    case State::CHUNK_SIZE:
+        if (!parseChunkSize(data, begin, end)) {
+            fail("malformed chunk size");
+            return false;
+        }
+        if (chunkLeft_ > limits_.maxBodyBytes - contentLength_) {
+            fail("chunked body too large");
+            return false;
+        }
+        contentLength_ += chunkLeft_;
+        if (chunkLeft_ == 0) {
+            sectionStart_ = next;
+            state_ = State::TRAILERS;
+        } else {
+            state_ = State::CHUNK_DATA;
+        }
+        return true;
+
+    case State::CHUNK_END:
+        if (end != begin) {
+            fail("missing CRLF after chunk data");
+            return false;
+        }
+        state_ = State::CHUNK_SIZE;
+        return true;
+
+    case State::TRAILERS:
+        // trailer 字段不合并进 headers, 空行结束请求
+        if (end == begin) requestEnd_ = next;
+        return true;
+
+    default:
+        fail("unexpected parser state");
+        return false;
+    }
+}
+
+bool HttpRequestParser::parseChunkSize(const char* data, size_t begin, size_t end) {
+    // chunk-size [ ";" chunk-ext ], 扩展参数忽略
+    uint64_t value = 0;
+    size_t pos = begin;
+    for (; pos < end; ++pos) {
+        const int digit = hexValue(data[pos]);
+        if (digit < 0) break;
+        if (value >> 60) return false; // 超过 64 位
+        value = (value << 4) | static_cast<uint64_t>(digit);
+    }
+    if (pos == begin) return false;
+    while (pos < end && isBlank(data[pos])) ++pos;
+    if (pos != end && data[pos] != ';') return false;
+    chunkLeft_ = value;
+    return true;
+}
+
+bool HttpRequestParser::parseRequestLine(const char* data, size_t begin, size_t end) {
+    // METHOD SP TARGET SP VERSION, 容忍多余空白
+    Span* fields[] = {&method_, &target_, &version_};
+    size_t pos = begin;
+    for (Span* field : fields) {
+        while (pos < end && isBlank(data[pos])) ++pos;
+        const size_t start = pos;
+        while (pos < end && !isBlank(data[pos])) ++pos;
+        if (pos == start) return false;
+        *field = Span{start, pos - start};
+    }
+    while (pos < end && isBlank(data[pos])) ++pos;
+    return pos == end;
+}
+
+bool HttpRequestParser::parseHeaderLine(const char* data, size_t begin, size_t end) {
+    const void* colonPtr = std::memchr(data + begin, ':', end - begin);
+    if (!colonPtr) return true; // 与旧实现一致: 忽略没有冒号的行
+    const size_t colon = static_cast<size_t>(static_cast<const char*>(colonPtr) - data);
+
+    size_t nameBegin = begin;
+    size_t nameEnd = colon;
+    while (nameBegin < nameEnd && isBlank(data[nameBegin])) ++nameBegin;
+    while (nameEnd > nameBegin && isBlank(data[nameEnd - 1])) --nameEnd;
+    if (nameBegin == nameEnd) return true;
+
+    size_t valueBegin = colon + 1;
+    size_t valueEnd = end;
+    while (valueBegin < valueEnd && isBlank(data[valueBegin])) ++valueBegin;
+    while (valueEnd > valueBegin && isBlank(data[valueEnd - 1])) --valueEnd;
+
+    const char* name = data + nameBegin;
+    const size_t nameLen = nameEnd - nameBegin;
+    if (equalsLower(name, nameLen, "transfer-encoding")) {
+        // 只支持以 chunked 结尾的编码, 其余无法确定请求边界
+        if (!endsWithChunked(data + valueBegin, valueEnd - valueBegin)) return false;
+        chunked_ = true;
+    } else if (equalsLower(name, nameLen, "content-length")) {
+        if (valueBegin == valueEnd) return false;
+        uint64_t value = 0;
+        for (size_t i = valueBegin; i < valueEnd; ++i) {
+            const char c = data[i];
+            if (c < '0' || c > '9') return false;
+            value = value * 10 + static_cast<uint64_t>(c - '0');
+            if (value > limits_.maxBodyBytes) return false;
+        }
+        contentLength_ = value;
+        hasContentLength_ = true;
+    }
+
+    headers_.push_back(HeaderSpan{Span{nameBegin, nameLen}, Span{valueBegin, valueEnd - valueBegin}});
+    return true;
+}
+
+void HttpRequestParser::emit(const char* data, HttpRequest& out) const {
+    out.method.assign(data + method_.offset, method_.length);
+    out.target.assign(data + target_.offset, target_.length);
+    out.version.assign(data + version_.offset, version_.length);
+
+    out.headers.clear();
+    out.headers.reserve(headers_.size());
+    for (const auto& h : headers_) {
+        // 重复的头部以最后一个为准
+        out.headers[std::string(data + h.name.offset, h.name.length)]
+            .assign(data + h.value.offset, h.value.length);
+    }
+
+    if (!chunked_) {
+        out.body.assign(data + bodyStart_, static_cast<size_t>(contentLength_));
+        return;
+    }
+    out.body.clear();
+    out.body.reserve(static_cast<size_t>(contentLength_));
+    for (const auto& chunk : chunks_) out.body.append(data + chunk.offset, chunk.length);
+}
+
+} // namespace net
+} // namespace utils
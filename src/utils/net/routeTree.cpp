@@ -0,0 +1,186 @@
+/*
+ * @FilePath: /src/utils/net/routeTree.cpp
+ * @Author: SweerItTer xxxzhou.xian@gmail.com
+ * @Date: 2026-03-16
+ * @LastEditors: SweerItTer xxxzhou.xian@gmail.com
+ * @Description: Radix tree matching HTTP path patterns with parameters and wildcards
+ */
+
+#include "net/routeTree.h"
+
+#include <cstring>
+
+namespace utils {
+namespace net {
+
+struct RouteTree::Node {
+    std::string prefix;  // 静态片段, 与兄弟节点的首字符互不相同
+    std::string indices; // children 各自 prefix 的首字符, 下标一一对应
+    std::vector<std::unique_ptr<Node>> children;
+    std::unique_ptr<Node> param;    // ":name" 子节点, prefix 为空
+    std::unique_ptr<Node> catchAll; // "*name" 子节点, 只能是叶子
+    std::string name;               // param / catchAll 节点的参数名
+    size_t routeId{0};
+    bool hasRoute{false};
+};
+
+namespace {
+
+void setError(std::string* error, std::string message) {
+    if (error) *error = std::move(message);
+}
+
+// 段首的 ':' / '*' 才是特殊字符, "/a:b" 仍是静态路径
+bool isSpecialAt(const std::string& path, size_t i) {
+    return (path[i] == ':' || path[i] == '*') && i > 0 && path[i - 1] == '/';
+}
+
+} // namespace
+
+RouteTree::RouteTree() = default;
+RouteTree::~RouteTree() = default;
+RouteTree::RouteTree(RouteTree&&) noexcept = default;
+RouteTree& RouteTree::operator=(RouteTree&&) noexcept = default;
+
+bool RouteTree::isPattern(const std::string& path) {
+    for (size_t i = 1; i < path.size(); ++i) {
+        if (isSpecialAt(path, i)) return true;
+    }
+    return false;
+}
+
+// 在 cur 之下插入静态片段 s, 必要时拆分已有节点的公共前缀; 返回 s 末尾对应的节点
+RouteTree::Node* RouteTree::insertStatic(Node* cur, const std::string& s) {
+    size_t i = 0;
+    while (i < s.size()) {
+        const size_t k = cur->indices.find(s[i]);
+        if (k == std::string::npos) {
+            std::unique_ptr<Node> child(new Node());
+            child->prefix = s.substr(i);
+            cur->indices.push_back(s[i]);
+            cur->children.push_back(std::move(child));
+            return cur->children.back().get();
+        }
+
+        Node* child = cur->children[k].get();
+        size_t common = 0;
+        while (common < child->prefix.size() && i + common < s.size() &&
+               child->prefix[common] == s[i + common]) {
+            ++common;
+        }
+        if (common < child->prefix.size()) {
+            std::unique_ptr<Node> mid(new Node());
+            mid->prefix = child->prefix.substr(0, common);
+            child->prefix.erase(0, common);
+            mid->indices.push_back(child->prefix[0]);
+            mid->children.push_back(std::move(cur->children[k]));
+            cur->children[k] = std::move(mid);
+            child = cur->children[k].get();
+        }
+        cur = child;
+        i += common;
+    }
+    return cur;
+}
+
+bool RouteTree::insert(const std::string& pattern, size_t routeId, std::string* error) {
+    if (pattern.empty() || pattern[0] != '/') {
+        setError(error, "Route pattern must start with '/': " + pattern);
+        return false;
+    }
+    if (!root_) root_.reset(new Node());
+
+    // 先校验整条模式, 避免失败时留下半截分支
+    for (size_t i = 1; i < pattern.size(); ++i) {
+        if (!isSpecialAt(pattern, i)) continue;
+        size_t end = pattern.find('/', i);
+        if (end == std::string::npos) end = pattern.size();
+        if (pattern[i] == ':' && end == i + 1) {
+            setError(error, "Empty parameter name in route pattern: " + pattern);
+            return false;
+        }
+        if (pattern[i] == '*' && end != pattern.size()) {
+            setError(error, "Wildcard must be the last segment of route pattern: " + pattern);
+            return false;
+        }
+    }
+
+    Node* cur = root_.get();
+    size_t pos = 0;
+    while (true) {
+        size_t special = pos;
+        while (special < pattern.size() && !isSpecialAt(pattern, special)) ++special;
+        cur = insertStatic(cur, pattern.substr(pos, special - pos));
+        if (special == pattern.size()) break;
+
+        size_t end = pattern.find('/', special);
+        if (end == std::string::npos) end = pattern.size();
+        std::string name = pattern.substr(special + 1, end - special - 1);
+        const bool wildcard = (pattern[special] == '*');
+        if (wildcard && name.empty()) name = "*";
+
+        std::unique_ptr<Node>& child = wildcard ? cur->catchAll : cur->param;
+        if (!child) {
+            child.reset(new Node());
+            child->name = std::move(name);
+        } else if (child->name != name) {
+            setError(error, "Route pattern '" + pattern + "' conflicts with parameter '" + child->name +
+                            "' at the same position");
+            return false;
+        }
+        cur = child.get();
+        pos = end;
+    }
+
+    if (cur->hasRoute) {
+        setError(error, "Duplicate route pattern: " + pattern);
+        return false;
+    }
+    cur->routeId = routeId;
+    cur->hasRoute = true;
+    return true;
+}
+
+bool RouteTree::matchNode(const Node* n, const std::string& path, size_t pos, size_t& routeId, HttpParams& params) {
+    if (pos == path.size()) {
+        if (n->hasRoute) {
+            routeId = n->routeId;
+            return true;
+        }
+    } else {
+        // 静态分支: 兄弟节点首字符互不相同, 至多一个候选
+        const void* hit = std::memchr(n->indices.data(), path[pos], n->indices.size());
+        if (hit) {
+            const Node* child = n->children[static_cast<const char*>(hit) - n->indices.data()].get();
+            if (path.compare(pos, child->prefix.size(), child->prefix) == 0 &&
+                matchNode(child, path, pos + child->prefix.size(), routeId, params)) {
+                return true;
+            }
+        }
+
+        if (n->param) {
+            size_t end = path.find('/', pos);
+            if (end == std::string::npos) end = path.size();
+            if (end > pos) {
+                params.emplace_back(n->param->name, path.substr(pos, end - pos));
+                if (matchNode(n->param.get(), path, end, routeId, params)) return true;
+                params.pop_back();
+            }
+        }
+    }
+
+    if (n->catchAll && n->catchAll->hasRoute) {
+        params.emplace_back(n->catchAll->name, path.substr(pos));
+        routeId = n->catchAll->routeId;
+        return true;
+    }
+    return false;
+}
+
+bool RouteTree::match(const std::string& path, size_t& routeId, HttpParams& params) const {
+    if (!root_ || path.empty() || path[0] != '/') return false;
+    return matchNode(root_.get(), path, 0, routeId, params);
+}
+
+} // namespace net
+} // namespace utils
@@ -7,14 +7,17 @@
  */
 
 #include "net/server.h"
+#include "net/httpParser.h"
+#include "net/inputBuffer.h"
 
 #include <algorithm>
 #include <cctype>
 #include <chrono>
+#include <cstdio>
 #include <cstring>
 #include <deque>
 #include <mutex>
-#include <sstream>
+#include <queue>
 #include <thread>
 
 #include <arpa/inet.h>
@@ -27,6 +30,7 @@
 #include <sys/sendfile.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #if defined(__has_include)
@@ -81,13 +85,18 @@ static bool sendAll(int fd, const char* data, size_t len) {
     return true;
 }
 
-static bool looksLikeHttp(const std::string& s) {
+static bool looksLikeHttp(const char* data, size_t len) {
     // Very small heuristic: method SP path SP HTTP/1.
+    static const char kVersion[] = " HTTP/1.";
     const char* methods[] = {"GET ", "POST ", "PUT ", "DELETE ", "HEAD ", "OPTIONS ", "PATCH "};
     for (const char* m : methods) {
-        if (s.rfind(m, 0) == 0) {
-            if (s.find(" HTTP/1.") != std::string::npos) return true;
-        }
+        const size_t mlen = std::strlen(m);
+        if (len < mlen || std::memcmp(data, m, mlen) != 0) continue;
+        // 只在第一行内查找版本号
+        const void* nl = std::memchr(data, '\n', len);
+        const size_t lineLen = nl ? static_cast<size_t>(static_cast<const char*>(nl) - data) : len;
+        const char* end = data + lineLen;
+        return std::search(data, end, kVersion, kVersion + sizeof(kVersion) - 1) != end;
     }
     return false;
 }
@@ -97,13 +106,6 @@ static std::string toLower(std::string s) {
     return s;
 }
 
-static std::string trim(std::string s) {
-    auto isSpace = [](unsigned char c) { return std::isspace(c) != 0; };
-    while (!s.empty() && isSpace(static_cast<unsigned char>(s.front()))) s.erase(s.begin());
-    while (!s.empty() && isSpace(static_cast<unsigned char>(s.back()))) s.pop_back();
-    return s;
-}
-
 static std::string stripQuery(std::string target) {
     const auto q = target.find('?');
     if (q != std::string::npos) target.resize(q);
@@ -154,9 +156,16 @@ Response LineRouter::dispatch(const ConnectionContext& ctx, const LineRequest& r
 
 bool HttpRouter::on(std::string method, std::string path, HttpHandler handler) {
     if (method.empty() || path.empty() || !handler) return false;
-    MethodHandlers& methodHandlers = handlers_[normalizeMethod(std::move(method))];
-    const auto inserted = methodHandlers.emplace(std::move(path), std::move(handler));
-    return inserted.second;
+    if (!RouteTree::isPattern(path)) {
+        MethodHandlers& methodHandlers = handlers_[normalizeMethod(std::move(method))];
+        const auto inserted = methodHandlers.emplace(std::move(path), std::move(handler));
+        return inserted.second;
+    }
+
+    RouteTree& tree = patterns_[normalizeMethod(std::move(method))];
+    if (!tree.insert(path, routeHandlers_.size())) return false;
+    routeHandlers_.push_back(std::move(handler));
+    return true;
 }
 
 bool HttpRouter::get(std::string path, HttpHandler handler) {
@@ -187,13 +196,31 @@ bool HttpRouter::options(std::string path, HttpHandler handler) {
     return on("OPTIONS", std::move(path), std::move(handler));
 }
 
-static bool pathExistsInAnyMethod(const std::unordered_map<std::string, HttpRouter::MethodHandlers>& handlers,
-                                  const std::string& path) {
-    for (const auto& entry : handlers) {
+bool HttpRouter::mount(std::string prefix, HttpHandler handler) {
+    if (prefix.empty() || prefix[0] != '/' || !handler) return false;
+    while (prefix.size() > 1 && prefix.back() == '/') prefix.pop_back();
+    if (prefix == "/") prefix.clear();
+
+    // "/api" 本身与 "/api/..." 共用一个 handler; "/api/*" 已存在时 "/api" 必然先冲突, 不会只插入一半
+    const size_t routeId = routeHandlers_.size();
+    if ((!prefix.empty() && !mounts_.insert(prefix, routeId)) || !mounts_.insert(prefix + "/*", routeId)) {
+        return false;
+    }
+    routeHandlers_.push_back(std::move(handler));
+    return true;
+}
+
+bool HttpRouter::pathExistsInAnyMethod(const std::string& path) const {
+    for (const auto& entry : handlers_) {
         if (entry.second.find(path) != entry.second.end()) {
             return true;
         }
     }
+    size_t routeId = 0;
+    HttpParams scratch;
+    for (const auto& entry : patterns_) {
+        if (entry.second.match(path, routeId, scratch)) return true;
+    }
     return false;
 }
 
@@ -220,8 +247,14 @@ static Response serveStaticFile(const HttpRequest& req, const std::string& fullP
 }
 
 Response HttpRouter::dispatch(const ConnectionContext& ctx, const HttpRequest& req) const {
-    (void)ctx;
+    return route(ctx, req, nullptr);
+}
+
+Response HttpRouter::dispatch(const ConnectionContext& ctx, HttpRequest& req) const {
+    return route(ctx, req, &req);
+}
 
+Response HttpRouter::route(const ConnectionContext& ctx, const HttpRequest& req, HttpRequest* writable) const {
     const auto connIt = req.headers.find("connection");
     const bool keepAlive = !(connIt != req.headers.end() && toLower(connIt->second) == "close");
 
@@ -235,7 +268,23 @@ Response HttpRouter::dispatch(const ConnectionContext& ctx, const HttpRequest& r
             return handlerIt->second(ctx, req);
         }
     }
-    if (pathExistsInAnyMethod(handlers_, targetPath)) {
+
+    // 模式路由与前缀挂载: 只有精确查找未命中才走到这里
+    HttpParams params;
+    size_t routeId = 0;
+    const auto patternIt = patterns_.find(method);
+    if ((patternIt != patterns_.end() && patternIt->second.match(targetPath, routeId, params)) ||
+        mounts_.match(targetPath, routeId, params)) {
+        if (writable) {
+            writable->params = std::move(params);
+            return routeHandlers_[routeId](ctx, *writable);
+        }
+        HttpRequest routed(req);
+        routed.params = std::move(params);
+        return routeHandlers_[routeId](ctx, routed);
+    }
+
+    if (pathExistsInAnyMethod(targetPath)) {
         return HttpResponse::methodNotAllowed().keepAlive(keepAlive).toResponse();
     }
 
@@ -263,34 +312,83 @@ Response HttpRouter::dispatch(const ConnectionContext& ctx, const HttpRequest& r
     return HttpResponse::notFound().keepAlive(keepAlive).toResponse();
 }
 
+// 打开一个非阻塞监听 socket; reusePort 为真时设置 SO_REUSEPORT, 供多个 reactor 绑定同一端口
+static int openListener(const ServerConfig& cfg, uint16_t port, bool reusePort) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    auto fail = [fd]() {
+        ::close(fd);
+        return -1;
+    };
+
+    int opt = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+#ifdef SO_REUSEPORT
+    if (reusePort && ::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) != 0) return fail();
+#else
+    if (reusePort) return fail();
+#endif
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (cfg.bindAddress == "0.0.0.0") {
+        addr.sin_addr.s_addr = INADDR_ANY;
+    } else if (::inet_pton(AF_INET, cfg.bindAddress.c_str(), &addr.sin_addr) <= 0) {
+        return fail();
+    }
+
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) return fail();
+    if (!setNonBlocking(fd)) return fail();
+    if (::listen(fd, static_cast<int>(cfg.maxClients)) < 0) return fail();
+    return fd;
+}
+
+static uint16_t boundPort(int fd) {
+    sockaddr_in addr{};
+    socklen_t len = sizeof(addr);
+    if (::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) return 0;
+    return ntohs(addr.sin_port);
+}
+
+/*
+ * Server::Impl - 多 reactor 结构
+ * 每个 reactor 一个线程, 独占自己的 epoll / eventfd / 连接表, 连接只在所属 reactor 线程上读写.
+ * 连接分配: ioThreads > 1 时优先每个 reactor 一个 SO_REUSEPORT 监听 socket, 由内核分散新连接;
+ * 否则 (或 SO_REUSEPORT 不可用) 由 reactor 0 accept, 轮询交给各 reactor.
+ * worker 产生的响应投递回连接所属 reactor 的 pending 队列并通过其 eventfd 唤醒.
+ */
 class Server::Impl {
 public:
     explicit Impl(Server& owner) : owner_(owner) {}
+    ~Impl();
 
-    bool start() {
-        if (thread_.joinable()) return false;
+    bool start();
+    void stop();
+    void join();
+    ServerStats stats() const;
 
-        const int listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
-        if (listenFd < 0) return false;
+private:
+    class Reactor;
 
-        FdWrapper listenWrap(listenFd);
+    // 每个 reactor 各自监听 (SO_REUSEPORT), 失败则退回单监听 + 轮询分发
+    bool openListeners(std::vector<std::unique_ptr<Reactor>>& reactors);
+    Reactor& nextReactor();
 
-        int opt = 1;
-        ::setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+    Server& owner_;
+    std::vector<std::unique_ptr<Reactor>> reactors_;
+    std::atomic<uint64_t> nextConnId_{1};
+    std::atomic<uint32_t> nextReactor_{0};
+};
 
-        sockaddr_in addr{};
-        addr.sin_family = AF_INET;
-        addr.sin_port = htons(owner_.cfg_.port);
-        if (owner_.cfg_.bindAddress == "0.0.0.0") {
-            addr.sin_addr.s_addr = INADDR_ANY;
-        } else if (::inet_pton(AF_INET, owner_.cfg_.bindAddress.c_str(), &addr.sin_addr) <= 0) {
-            return false;
-        }
+class Server::Impl::Reactor {
+    using Clock = std::chrono::steady_clock;
 
-        if (::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) return false;
-        if (!setNonBlocking(listenFd)) return false;
-        if (::listen(listenFd, static_cast<int>(owner_.cfg_.maxClients)) < 0) return false;
+public:
+    explicit Reactor(Impl& impl) : impl_(impl), owner_(impl.owner_) {}
+    ~Reactor() { closeAdopted(); }
 
+    bool init() {
         const int epfd = ::epoll_create1(EPOLL_CLOEXEC);
         if (epfd < 0) return false;
         epollFd_ = FdWrapper(epfd);
@@ -299,20 +397,26 @@ public:
         if (efd < 0) return false;
         wakeFd_ = FdWrapper(efd);
 
-        listenFd_ = std::move(listenWrap);
+        epoll_event wev{};
+        wev.events = EPOLLIN;
+        wev.data.u64 = kWakeToken;
+        return ::epoll_ctl(epollFd_.get(), EPOLL_CTL_ADD, wakeFd_.get(), &wev) == 0;
+    }
 
+    // distribute 为真时本 reactor 是唯一的 acceptor, 新连接轮询交给所有 reactor
+    bool listen(FdWrapper fd, bool distribute) {
+        listenFd_ = std::move(fd);
+        distribute_ = distribute;
         epoll_event ev{};
         ev.events = EPOLLIN;
         ev.data.u64 = kListenToken;
-        ::epoll_ctl(epollFd_.get(), EPOLL_CTL_ADD, listenFd_.get(), &ev);
-
-        epoll_event wev{};
-        wev.events = EPOLLIN;
-        wev.data.u64 = kWakeToken;
-        ::epoll_ctl(epollFd_.get(), EPOLL_CTL_ADD, wakeFd_.get(), &wev);
+        return ::epoll_ctl(epollFd_.get(), EPOLL_CTL_ADD, listenFd_.get(), &ev) == 0;
+    }
 
+    void run() {
+        running_.store(true);
+        now_ = Clock::now();
         thread_ = std::thread([this] { loop(); });
-        return true;
     }
 
     void stop() {
@@ -327,22 +431,63 @@ public:
         if (thread_.joinable()) thread_.join();
     }
 
-    void postResponse(uint64_t connId, Response resp) {
+    // seq 为分发时分配的连接内序号, reactor 按序号顺序发出响应
+    void postResponse(uint64_t connId, uint64_t seq, Response resp) {
+        std::vector<Response> resps;
+        resps.push_back(std::move(resp));
+        postResponses(connId, seq, std::move(resps));
+    }
+
+    // 同一任务 (如一批行请求) 的全部响应, 占一个序号, 一次加锁一次唤醒
+    void postResponses(uint64_t connId, uint64_t seq, std::vector<Response> resps) {
         {
             std::lock_guard<std::mutex> lock(outMutex_);
-            pending_.emplace_back(Pending{connId, std::move(resp)});
+            pending_.emplace_back(Pending{connId, seq, std::move(resps)});
         }
         wake();
     }
 
+    // BodyStream 回调 (生产端线程): 流有新数据, 由本线程继续写出
+    void postStreamReady(uint64_t connId) {
+        {
+            std::lock_guard<std::mutex> lock(outMutex_);
+            streamReady_.push_back(connId);
+        }
+        wake();
+    }
+
+    // acceptor 把新连接交给本 reactor, 由本线程注册到自己的 epoll
+    void adopt(int fd, const sockaddr_in& peer) {
+        {
+            std::lock_guard<std::mutex> lock(outMutex_);
+            adopted_.emplace_back(Adopted{fd, peer});
+        }
+        wake();
+    }
+
+    // 可在任意线程调用
+    void addStats(ServerStats& out) const {
+        out.connectionsAccepted += counters_.accepted.load(std::memory_order_relaxed);
+        out.responsesSent += counters_.responses.load(std::memory_order_relaxed);
+        out.writeSyscalls += counters_.writeCalls.load(std::memory_order_relaxed);
+        out.pollUpdates += counters_.pollUpdates.load(std::memory_order_relaxed);
+        out.timedOutConnections += counters_.timedOut.load(std::memory_order_relaxed);
+    }
+
 private:
     struct Pending {
         uint64_t connId;
-        Response resp;
+        uint64_t seq;
+        std::vector<Response> resps;
+    };
+
+    struct Adopted {
+        int fd;
+        sockaddr_in peer;
     };
 
     struct Outgoing {
-        enum class Kind : uint8_t { BYTES, FILE_FD, DMABUF };
+        enum class Kind : uint8_t { BYTES, FILE_FD, DMABUF, STREAM };
         Kind kind{Kind::BYTES};
         std::string bytes;
         size_t bytesOffset{0};
@@ -350,22 +495,61 @@ private:
         uint64_t fileSent{0};
         Body::DmaBuf dmabuf;
         uint64_t dmabufSent{0};
+        Body::Stream stream;
+        bool last{false}; // 所属响应的最后一段, 写完即计一次响应
     };
 
     struct Connection {
         ConnectionContext ctx;
         FdWrapper fd;
-        std::string in;
+        InputBuffer in;
+        size_t lineScanned{0}; // 行协议: in 中已确认不含 '\n' 的前缀长度
+        HttpRequestParser parser;
         std::deque<Outgoing> out;
-        std::chrono::steady_clock::time_point lastActive{std::chrono::steady_clock::now()};
+        Clock::time_point lastActive;
+
+        // 超时阶段: HEADER/BODY 为收到请求的一部分后等待其余部分, phaseStart 为进入该阶段的时刻
+        enum class Phase : uint8_t { IDLE, HEADER, BODY };
+        Phase phase{Phase::IDLE};
+        Clock::time_point phaseStart;
+        Clock::time_point timerAt{Clock::time_point::max()}; // timers_ 中该连接最早的条目
+
+        // 重排窗口: window[i] 对应序号 nextSend + i 的任务, 队首就绪才能发送.
+        // window.size() 即已分发但尚未发出响应的任务数, 达到上限时暂停读取.
+        struct ReorderSlot {
+            bool ready{false};
+            std::vector<Response> resps;
+        };
+        std::deque<ReorderSlot> window;
+        uint64_t nextSend{0};
+
         bool isHttp{false}; // protocol chosen by sniff
         bool closing{false};
         bool wantWrite{false};
+        bool readPaused{false};
+    };
+
+    // 最小堆条目, 惰性删除: 弹出时与连接的 timerAt 不符或连接已关闭即丢弃
+    struct TimerEntry {
+        Clock::time_point at;
+        uint64_t connId;
+    };
+    struct TimerLater {
+        bool operator()(const TimerEntry& a, const TimerEntry& b) const { return a.at > b.at; }
     };
 
     static constexpr uint64_t kListenToken = 1;
     static constexpr uint64_t kWakeToken = 2;
     static constexpr uint64_t kConnTokenBase = 1000;
+    static constexpr size_t kReadChunk = 16 * 1024;
+    static constexpr size_t kMaxIov = 64;
+
+    // 停止后仍可能收到 acceptor 交来的连接, 关闭这些尚未注册的 fd
+    void closeAdopted() {
+        std::lock_guard<std::mutex> lock(outMutex_);
+        for (const auto& a : adopted_) ::close(a.fd);
+        adopted_.clear();
+    }
 
     void wake() {
         const uint64_t one = 1;
@@ -374,13 +558,12 @@ private:
     }
 
     void loop() {
-        running_.store(true);
         std::vector<epoll_event> events;
         events.resize(64);
 
         while (running_.load()) {
-            const int n = ::epoll_wait(epollFd_.get(), events.data(), static_cast<int>(events.size()), 1000);
-            const auto now = std::chrono::steady_clock::now();
+            const int n = ::epoll_wait(epollFd_.get(), events.data(), static_cast<int>(events.size()), pollTimeoutMs());
+            now_ = Clock::now();
 
             if (n < 0) {
                 if (errno == EINTR) continue;
@@ -405,7 +588,7 @@ private:
                 }
             }
 
-            reapIdle(now);
+            expireTimers();
         }
 
         // shutdown all
@@ -413,43 +596,57 @@ private:
         ids.reserve(conns_.size());
         for (const auto& kv : conns_) ids.push_back(kv.first);
         for (auto id : ids) closeConn(id);
+
+        closeAdopted();
     }
 
     void acceptAll() {
         while (true) {
             sockaddr_in client{};
             socklen_t len = sizeof(client);
-            const int fd = ::accept(listenFd_.get(), reinterpret_cast<sockaddr*>(&client), &len);
+            const int fd = ::accept4(listenFd_.get(), reinterpret_cast<sockaddr*>(&client), &len,
+                                     SOCK_NONBLOCK | SOCK_CLOEXEC);
             if (fd < 0) {
                 if (errno == EAGAIN || errno == EWOULDBLOCK) break;
                 break;
             }
 
-            if (!setNonBlocking(fd)) {
-                ::close(fd);
-                continue;
+            Reactor& target = distribute_ ? impl_.nextReactor() : *this;
+            if (&target == this) {
+                addConnection(fd, client);
+            } else {
+                target.adopt(fd, client);
             }
-            setTcpKeepAliveOptions(fd, owner_.cfg_);
-
-            char ip[INET_ADDRSTRLEN] = {0};
-            ::inet_ntop(AF_INET, &client.sin_addr, ip, sizeof(ip));
-            const uint16_t port = ntohs(client.sin_port);
-
-            const uint64_t id = nextConnId_++;
-            Connection c;
-            c.ctx.id = id;
-            c.ctx.peer.ip = ip;
-            c.ctx.peer.port = port;
-            c.fd = FdWrapper(fd);
-            c.in.reserve(8192);
+        }
+    }
 
-            conns_.emplace(id, std::move(c));
+    void addConnection(int fd, const sockaddr_in& client) {
+        setTcpKeepAliveOptions(fd, owner_.cfg_);
+        // 响应 head/body 分开发送, 关闭 Nagle 避免与客户端 delayed ACK 叠加出 40ms 停顿
+        int noDelay = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+        char ip[INET_ADDRSTRLEN] = {0};
+        ::inet_ntop(AF_INET, &client.sin_addr, ip, sizeof(ip));
+        const uint16_t port = ntohs(client.sin_port);
+
+        // 连接 id 全局唯一, 便于日志与 handler 区分不同 reactor 上的连接
+        const uint64_t id = impl_.nextConnId_.fetch_add(1, std::memory_order_relaxed);
+        counters_.accepted.fetch_add(1, std::memory_order_relaxed);
+        Connection c;
+        c.ctx.id = id;
+        c.ctx.peer.ip = ip;
+        c.ctx.peer.port = port;
+        c.fd = FdWrapper(fd);
+        c.lastActive = now_;
+
+        auto& conn = conns_.emplace(id, std::move(c)).first->second;
+        schedule(conn);
 
-            epoll_event ev{};
-            ev.events = EPOLLIN;
-            ev.data.u64 = kConnTokenBase + id;
-            ::epoll_ctl(epollFd_.get(), EPOLL_CTL_ADD, fd, &ev);
-        }
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = kConnTokenBase + id;
+        ::epoll_ctl(epollFd_.get(), EPOLL_CTL_ADD, fd, &ev);
     }
 
     void drainWake() {
@@ -459,19 +656,65 @@ private:
 
     void drainPending() {
         std::deque<Pending> local;
+        std::deque<Adopted> adopted;
+        std::vector<uint64_t> touched;
         {
             std::lock_guard<std::mutex> lock(outMutex_);
             local.swap(pending_);
+            adopted.swap(adopted_);
+            touched.swap(streamReady_);
         }
 
+        for (const auto& a : adopted) addConnection(a.fd, a.peer);
+
         for (auto& p : local) {
             auto it = conns_.find(p.connId);
             if (it == conns_.end()) continue;
-            enqueueResponse(it->second, std::move(p.resp));
+            complete(it->second, p.seq, std::move(p.resps));
+            if (touched.empty() || touched.back() != p.connId) touched.push_back(p.connId);
+        }
+
+        // 直接尝试写出, 只有写不完时才关注 EPOLLOUT
+        std::sort(touched.begin(), touched.end());
+        touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+        for (const uint64_t id : touched) onWritable(id);
+    }
+
+    // 为即将分发的任务分配序号并在窗口中占位
+    uint64_t reserveSeq(Connection& c) {
+        c.window.emplace_back();
+        return c.nextSend + c.window.size() - 1;
+    }
+
+    bool windowFull(const Connection& c) const {
+        return c.window.size() >= std::max<uint32_t>(1, owner_.cfg_.maxPipelinedRequests);
+    }
+
+    // 记录任务完成, 并按序号顺序把队首已就绪的响应移入发送队列
+    void complete(Connection& c, uint64_t seq, std::vector<Response> resps) {
+        const size_t index = static_cast<size_t>(seq - c.nextSend);
+        if (seq < c.nextSend || index >= c.window.size()) return;
+        c.window[index].ready = true;
+        c.window[index].resps = std::move(resps);
+
+        while (!c.window.empty() && c.window.front().ready) {
+            for (auto& resp : c.window.front().resps) enqueueResponse(c, std::move(resp));
+            c.window.pop_front();
+            ++c.nextSend;
+        }
+
+        if (c.readPaused && !windowFull(c)) {
+            // 窗口有空位: 恢复读取, 并继续解析暂停期间已缓存的请求
+            c.readPaused = false;
+            updateEvents(c);
+            processInput(c);
         }
     }
 
+    // 只入队, 由调用方在本轮处理结束后统一 flush, 使同一轮完成的多个响应合并写出
     void enqueueResponse(Connection& c, Response resp) {
+        if (c.closing) return; // 已决定关闭, 之后的响应不再发送
+        const size_t before = c.out.size();
         if (!resp.head.empty()) {
             Outgoing o;
             o.kind = Outgoing::Kind::BYTES;
@@ -480,10 +723,12 @@ private:
         }
 
         if (resp.body.kind == Body::Kind::BYTES) {
-            Outgoing o;
-            o.kind = Outgoing::Kind::BYTES;
-            o.bytes = std::move(resp.body.bytes);
-            c.out.push_back(std::move(o));
+            if (!resp.body.bytes.empty()) {
+                Outgoing o;
+                o.kind = Outgoing::Kind::BYTES;
+                o.bytes = std::move(resp.body.bytes);
+                c.out.push_back(std::move(o));
+            }
         } else if (resp.body.kind == Body::Kind::FILE_FD) {
             Outgoing o;
             o.kind = Outgoing::Kind::FILE_FD;
@@ -494,28 +739,49 @@ private:
             o.kind = Outgoing::Kind::DMABUF;
             o.dmabuf = std::move(resp.body.dmabuf);
             c.out.push_back(std::move(o));
+        } else if (resp.body.kind == Body::Kind::STREAM && resp.body.stream.source) {
+            const uint64_t id = c.ctx.id;
+            resp.body.stream.source->setReadyCallback([this, id] { postStreamReady(id); });
+            Outgoing o;
+            o.kind = Outgoing::Kind::STREAM;
+            o.stream = std::move(resp.body.stream);
+            c.out.push_back(std::move(o));
         }
 
+        if (c.out.size() > before) {
+            c.out.back().last = true;
+        } else {
+            counters_.responses.fetch_add(1, std::memory_order_relaxed);
+        }
         if (resp.close) c.closing = true;
-        enableWrite(c);
     }
 
-    void enableWrite(Connection& c) {
-        if (c.wantWrite) return;
-        c.wantWrite = true;
+    void updateEvents(Connection& c) {
         epoll_event ev{};
-        ev.events = EPOLLIN | EPOLLOUT;
+        ev.events = (c.readPaused ? 0u : static_cast<uint32_t>(EPOLLIN)) |
+                    (c.wantWrite ? static_cast<uint32_t>(EPOLLOUT) : 0u);
         ev.data.u64 = kConnTokenBase + c.ctx.id;
         ::epoll_ctl(epollFd_.get(), EPOLL_CTL_MOD, c.fd.get(), &ev);
+        counters_.pollUpdates.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void enableWrite(Connection& c) {
+        if (c.wantWrite) return;
+        c.wantWrite = true;
+        updateEvents(c);
     }
 
     void disableWrite(Connection& c) {
         if (!c.wantWrite) return;
         c.wantWrite = false;
-        epoll_event ev{};
-        ev.events = EPOLLIN;
-        ev.data.u64 = kConnTokenBase + c.ctx.id;
-        ::epoll_ctl(epollFd_.get(), EPOLL_CTL_MOD, c.fd.get(), &ev);
+        updateEvents(c);
+    }
+
+    // 在途任务达到上限: 停止从 socket 读取, 由 complete() 恢复
+    void pauseReading(Connection& c) {
+        if (c.readPaused) return;
+        c.readPaused = true;
+        updateEvents(c);
     }
 
     void onReadable(uint64_t id) {
@@ -523,12 +789,13 @@ private:
         if (it == conns_.end()) return;
         Connection& c = it->second;
 
-        char buf[4096];
+        // 直接 recv 到连接缓冲的空闲区
         while (true) {
-            const ssize_t n = ::recv(c.fd.get(), buf, sizeof(buf), 0);
+            char* dst = c.in.prepare(kReadChunk);
+            const ssize_t n = ::recv(c.fd.get(), dst, c.in.writable(), 0);
             if (n > 0) {
-                c.lastActive = std::chrono::steady_clock::now();
-                c.in.append(buf, static_cast<size_t>(n));
+                c.lastActive = now_;
+                c.in.commit(static_cast<size_t>(n));
                 continue;
             }
             if (n == 0) {
@@ -540,92 +807,324 @@ private:
             return;
         }
 
-        if (!c.isHttp && looksLikeHttp(c.in)) c.isHttp = true;
+        processInput(c);
+        c.in.shrinkIfIdle();
+        if (!c.out.empty()) onWritable(id); // 如解析失败产生的 400
+    }
+
+    void processInput(Connection& c) {
+        if (!c.isHttp && looksLikeHttp(c.in.data(), c.in.size())) c.isHttp = true;
 
         if (c.isHttp) {
             processHttp(c);
         } else {
             processLine(c);
         }
+        updatePhase(c);
+    }
+
+    // 缓冲中剩下的是未收齐的请求时开始计 header/body 时限; 每收齐一个请求重新计时
+    void updatePhase(Connection& c) {
+        using Phase = Connection::Phase;
+        Phase phase = Phase::IDLE;
+        if (!c.in.empty()) phase = (c.isHttp && c.parser.inBody()) ? Phase::BODY : Phase::HEADER;
+        if (phase == c.phase) return;
+        c.phase = phase;
+        c.phaseStart = now_;
+        schedule(c);
+    }
+
+    static LineRequest makeLineRequest(const char* line, size_t len) {
+        LineRequest req;
+        req.raw.assign(line, len);
+        const void* sp = std::memchr(line, ' ', len);
+        if (!sp) {
+            req.command = req.raw;
+        } else {
+            const size_t cmdLen = static_cast<size_t>(static_cast<const char*>(sp) - line);
+            req.command.assign(line, cmdLen);
+            req.params.assign(line + cmdLen + 1, len - cmdLen - 1);
+        }
+        return req;
     }
 
     void processLine(Connection& c) {
-        // split by '\n', keep remainder
-        size_t pos = 0;
+        if (c.closing) return;
+        if (windowFull(c)) {
+            pauseReading(c);
+            return;
+        }
+
+        // 取出本次唤醒内所有完整行, 只推进读游标; 合成一个任务按到达顺序分发
+        std::vector<LineRequest> batch;
         while (true) {
-            const auto nl = c.in.find('\n', pos);
-            if (nl == std::string::npos) break;
-            std::string line = c.in.substr(0, nl);
-            c.in.erase(0, nl + 1);
-            pos = 0;
-            if (!line.empty() && line.back() == '\r') line.pop_back();
-            if (line.empty()) continue;
-
-            LineRequest req;
-            req.raw = line;
-            const auto sp = line.find(' ');
-            if (sp == std::string::npos) {
-                req.command = line;
-            } else {
-                req.command = line.substr(0, sp);
-                req.params = line.substr(sp + 1);
+            const char* begin = c.in.data();
+            const size_t avail = c.in.size();
+            const void* nl = (c.lineScanned < avail)
+                ? std::memchr(begin + c.lineScanned, '\n', avail - c.lineScanned)
+                : nullptr;
+            if (!nl) {
+                c.lineScanned = avail;
+                break;
+            }
+            const size_t lineEnd = static_cast<size_t>(static_cast<const char*>(nl) - begin);
+            size_t len = lineEnd;
+            if (len > 0 && begin[len - 1] == '\r') --len;
+            if (len > 0) batch.push_back(makeLineRequest(begin, len));
+            c.in.consume(lineEnd + 1);
+            c.lineScanned = 0;
+            c.phase = Connection::Phase::IDLE;
+        }
+        if (batch.empty()) return;
+
+        const uint64_t seq = reserveSeq(c);
+        const bool posted = owner_.workers_->post([this, ctx = c.ctx, seq, batch = std::move(batch)]() mutable {
+            std::vector<Response> resps;
+            resps.reserve(batch.size());
+            for (const auto& req : batch) {
+                // 处理器抛异常也必须占满序号, 否则后续响应永远等不到队首
+                try {
+                    resps.push_back(owner_.lineRouter_.dispatch(ctx, req));
+                } catch (...) {
+                    resps.push_back(Response::bytes("ERROR: Internal error\n"));
+                }
             }
+            postResponses(ctx.id, seq, std::move(resps));
+        });
+        if (!posted) {
+            // 线程池已停止: 回错误行并断开
+            c.in.clear();
+            postResponse(c.ctx.id, seq, Response::bytes("ERROR: Server unavailable\n", true));
+        }
+    }
+
+    void processHttp(Connection& c) {
+        // 已决定关闭或已回复 400 的连接, 丢弃后续输入
+        if (c.closing || c.parser.error()) {
+            c.in.clear();
+            return;
+        }
 
-            owner_.workers_->enqueue([this, ctx = c.ctx, req = std::move(req), connId = c.ctx.id]() mutable {
-                Response resp = owner_.lineRouter_.dispatch(ctx, req);
-                postResponse(connId, std::move(resp));
+        // 在缓冲区上连续解析多个 (pipelined) 请求, 最后一次性推进读游标
+        // 每个请求分配序号, 响应按请求顺序发出 (HTTP/1.1 pipelining)
+        size_t offset = 0;
+        while (offset < c.in.size()) {
+            if (windowFull(c)) {
+                pauseReading(c);
+                break;
+            }
+            HttpRequest req;
+            const auto status = c.parser.parse(c.in.data() + offset, c.in.size() - offset, req);
+            if (status == HttpRequestParser::Status::NEED_MORE) break;
+            if (status == HttpRequestParser::Status::ERROR) {
+                // 400 同样排在之前请求的响应之后
+                c.in.clear();
+                std::vector<Response> resps;
+                resps.push_back(HttpResponse::badRequest().keepAlive(false).toResponse());
+                complete(c, reserveSeq(c), std::move(resps));
+                return;
+            }
+            offset += c.parser.consumed();
+            c.phase = Connection::Phase::IDLE; // 请求已收齐
+            const uint64_t seq = reserveSeq(c);
+            const bool posted = owner_.workers_->post([this, ctx = c.ctx, seq, req = std::move(req)]() mutable {
+                // 处理器抛异常也必须占满序号, 否则后续 pipelined 响应永远等不到队首
+                Response resp;
+                try {
+                    resp = owner_.httpRouter_.dispatch(ctx, req);
+                } catch (...) {
+                    resp = HttpResponse::serverError().keepAlive(false).toResponse();
+                }
+                postResponse(ctx.id, seq, std::move(resp));
             });
+            if (!posted) {
+                // 线程池已停止: 回 500 并断开, 不再解析后续请求
+                c.in.clear();
+                postResponse(c.ctx.id, seq, HttpResponse::serverError().keepAlive(false).toResponse());
+                return;
+            }
         }
+        c.in.consume(offset);
+    }
+
+    enum class WriteStatus : uint8_t {
+        PROGRESS,
+        WOULD_BLOCK, // socket 发送缓冲已满, 等 EPOLLOUT
+        IDLE,        // 流式响应暂无数据, 等生产端回调
+        FAILED
+    };
+
+    static WriteStatus writeError() {
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? WriteStatus::WOULD_BLOCK : WriteStatus::FAILED;
+    }
+
+    static bool hasPayload(const Outgoing& o) {
+        if (o.kind == Outgoing::Kind::FILE_FD) return o.fileSent < o.file.length;
+        if (o.kind == Outgoing::Kind::DMABUF) return o.dmabuf.buf && o.dmabufSent < o.dmabuf.length;
+        if (o.kind == Outgoing::Kind::STREAM) return false; // 流数据何时到达未知, 不能推迟发送
+        return o.bytesOffset < o.bytes.size();
+    }
+
+    void popOut(Connection& c) {
+        if (c.out.front().last) counters_.responses.fetch_add(1, std::memory_order_relaxed);
+        c.out.pop_front();
     }
 
-    static bool tryParseHttp(std::string& buf, HttpRequest& out) {
-        const auto headerEnd = buf.find("\r\n\r\n");
-        if (headerEnd == std::string::npos) return false;
+    ssize_t countedSend(int fd, const void* data, size_t len, int flags) {
+        counters_.writeCalls.fetch_add(1, std::memory_order_relaxed);
+        return ::send(fd, data, len, flags);
+    }
 
-        const std::string headerBlock = buf.substr(0, headerEnd);
-        std::string remain = buf.substr(headerEnd + 4);
+    void pushFrontBytes(Connection& c, std::string bytes, bool last = false) {
+        Outgoing o;
+        o.kind = Outgoing::Kind::BYTES;
+        o.bytes = std::move(bytes);
+        o.last = last;
+        c.out.push_front(std::move(o));
+    }
 
-        std::istringstream iss(headerBlock);
-        std::string requestLine;
-        if (!std::getline(iss, requestLine)) return false;
-        if (!requestLine.empty() && requestLine.back() == '\r') requestLine.pop_back();
+    static std::string chunkHeader(size_t size) {
+        char buf[24];
+        const int n = std::snprintf(buf, sizeof(buf), "%zx\r\n", size);
+        return std::string(buf, static_cast<size_t>(n));
+    }
 
-        std::istringstream rl(requestLine);
-        rl >> out.method >> out.target >> out.version;
-        if (out.method.empty() || out.target.empty() || out.version.empty()) return false;
+    /*
+     * 流式响应位于队首说明之前取走的分块都已写出, 此时才取下一批, 连接上缓存的流数据因此有上限.
+     * 取到的分块 (chunked 时加上分帧) 作为 BYTES 段插到流之前, 由 writeBytes 合并写出.
+     */
+    WriteStatus writeStream(Connection& c) {
+        Outgoing& o = c.out.front();
+        std::deque<std::string> chunks;
+        switch (o.stream.source->read(chunks)) {
+        case BodyStream::ReadStatus::DATA: {
+            const bool chunked = o.stream.chunked;
+            for (auto it = chunks.rbegin(); it != chunks.rend(); ++it) {
+                const size_t size = it->size();
+                if (chunked) pushFrontBytes(c, "\r\n");
+                pushFrontBytes(c, std::move(*it));
+                if (chunked) pushFrontBytes(c, chunkHeader(size));
+            }
+            return WriteStatus::PROGRESS;
+        }
+        case BodyStream::ReadStatus::WAIT:
+            return WriteStatus::IDLE;
+        case BodyStream::ReadStatus::END: {
+            const bool chunked = o.stream.chunked;
+            const bool last = o.last;
+            c.out.pop_front();
+            if (chunked) {
+                pushFrontBytes(c, "0\r\n\r\n", last);
+            } else if (last) {
+                counters_.responses.fetch_add(1, std::memory_order_relaxed);
+            }
+            return WriteStatus::PROGRESS;
+        }
+        case BodyStream::ReadStatus::ABORTED:
+        default:
+            return WriteStatus::FAILED;
+        }
+    }
 
-        out.headers.clear();
-        std::string line;
-        while (std::getline(iss, line)) {
-            if (!line.empty() && line.back() == '\r') line.pop_back();
-            const auto colon = line.find(':');
-            if (colon == std::string::npos) continue;
-            const std::string k = toLower(trim(line.substr(0, colon)));
-            const std::string v = trim(line.substr(colon + 1));
-            if (!k.empty()) out.headers[k] = v;
+    /*
+     * 把队首连续的 BYTES 段 (可跨多个响应: head, body, 下一个响应的 head ...) 合并为一次 sendmsg.
+     * 紧随其后是文件/dmabuf 时带 MSG_MORE, 让 head 与文件开头进入同一个报文段.
+     * 部分写入时按 iovec 逐段推进 bytesOffset.
+     */
+    WriteStatus writeBytes(Connection& c) {
+        iovec iov[kMaxIov];
+        size_t count = 0;
+        size_t segments = 0;
+        auto it = c.out.begin();
+        for (; it != c.out.end() && it->kind == Outgoing::Kind::BYTES && count < kMaxIov; ++it, ++segments) {
+            const size_t len = it->bytes.size() - it->bytesOffset;
+            if (len == 0) continue;
+            iov[count].iov_base = const_cast<char*>(it->bytes.data()) + it->bytesOffset;
+            iov[count].iov_len = len;
+            ++count;
         }
 
-        // body (Content-Length only)
-        size_t need = 0;
-        const auto it = out.headers.find("content-length");
-        if (it != out.headers.end()) {
-            need = static_cast<size_t>(std::strtoul(it->second.c_str(), nullptr, 10));
+        size_t written = 0;
+        if (count > 0) {
+            int flags = MSG_NOSIGNAL;
+            if (it != c.out.end() && it->kind != Outgoing::Kind::BYTES && hasPayload(*it)) flags |= MSG_MORE;
+            msghdr msg{};
+            msg.msg_iov = iov;
+            msg.msg_iovlen = count;
+            counters_.writeCalls.fetch_add(1, std::memory_order_relaxed);
+            const ssize_t n = ::sendmsg(c.fd.get(), &msg, flags);
+            if (n < 0) return writeError();
+            written = static_cast<size_t>(n);
         }
-        if (remain.size() < need) return false;
 
-        out.body = remain.substr(0, need);
-        buf = remain.substr(need);
-        return true;
+        for (size_t i = 0; i < segments; ++i) {
+            Outgoing& o = c.out.front();
+            const size_t len = o.bytes.size() - o.bytesOffset;
+            if (written < len) {
+                o.bytesOffset += written;
+                return WriteStatus::WOULD_BLOCK; // 发送缓冲已满
+            }
+            written -= len;
+            popOut(c);
+        }
+        return WriteStatus::PROGRESS;
     }
 
-    void processHttp(Connection& c) {
-        HttpRequest req;
-        while (tryParseHttp(c.in, req)) {
-            owner_.workers_->enqueue([this, ctx = c.ctx, reqCopy = req, connId = c.ctx.id]() mutable {
-                Response resp = owner_.httpRouter_.dispatch(ctx, reqCopy);
-                postResponse(connId, std::move(resp));
-            });
+    WriteStatus writeFile(Connection& c) {
+        Outgoing& o = c.out.front();
+        off_t off = static_cast<off_t>(o.file.offset + o.fileSent);
+        const size_t left = static_cast<size_t>(o.file.length - o.fileSent);
+        if (left == 0) {
+            popOut(c);
+            return WriteStatus::PROGRESS;
+        }
+        counters_.writeCalls.fetch_add(1, std::memory_order_relaxed);
+        const ssize_t n = ::sendfile(c.fd.get(), o.file.fd.get(), &off, left);
+        if (n > 0) {
+            o.fileSent += static_cast<uint64_t>(n);
+            if (o.fileSent == o.file.length) popOut(c);
+            return WriteStatus::PROGRESS;
         }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return WriteStatus::WOULD_BLOCK;
+
+        // fallback to copy (read+send) for non-sendfile capable fd
+        char tmp[8192];
+        const ssize_t r = ::pread(o.file.fd.get(), tmp, sizeof(tmp),
+                                  static_cast<off_t>(o.file.offset + o.fileSent));
+        if (r <= 0) return WriteStatus::FAILED;
+        const ssize_t s = countedSend(c.fd.get(), tmp, static_cast<size_t>(r), MSG_NOSIGNAL);
+        if (s > 0) {
+            o.fileSent += static_cast<uint64_t>(s);
+            if (o.fileSent == o.file.length) popOut(c);
+            return WriteStatus::PROGRESS;
+        }
+        return (s < 0) ? writeError() : WriteStatus::WOULD_BLOCK;
+    }
+
+    WriteStatus writeDmaBuf(Connection& c) {
+#if UTILSCORE_NET_HAS_DMABUF
+        Outgoing& o = c.out.front();
+        if (!o.dmabuf.buf || o.dmabufSent >= o.dmabuf.length) {
+            popOut(c);
+            return WriteStatus::PROGRESS;
+        }
+        // v1: map + send (copy). Later: add platform-specific fast paths.
+        auto view = o.dmabuf.buf->scopedMap();
+        const uint64_t off = o.dmabuf.offset + o.dmabufSent;
+        const uint64_t left = o.dmabuf.length - o.dmabufSent;
+        const size_t chunk = static_cast<size_t>(std::min<uint64_t>(left, 64 * 1024));
+        const ssize_t n = countedSend(c.fd.get(), reinterpret_cast<const char*>(view.get() + off), chunk,
+                                      MSG_NOSIGNAL | (chunk < left ? MSG_MORE : 0));
+        if (n > 0) {
+            o.dmabufSent += static_cast<uint64_t>(n);
+            return WriteStatus::PROGRESS;
+        }
+        return (n < 0) ? writeError() : WriteStatus::WOULD_BLOCK;
+#else
+        // DMABUF not available in this build environment.
+        (void)c;
+        return WriteStatus::FAILED;
+#endif
     }
 
     void onWritable(uint64_t id) {
@@ -633,105 +1132,94 @@ private:
         if (it == conns_.end()) return;
         Connection& c = it->second;
 
-        while (!c.out.empty()) {
-            Outgoing& o = c.out.front();
-            if (o.kind == Outgoing::Kind::BYTES) {
-                const char* data = o.bytes.data() + o.bytesOffset;
-                const size_t len = o.bytes.size() - o.bytesOffset;
-                const ssize_t n = ::send(c.fd.get(), data, len, MSG_NOSIGNAL);
-                if (n > 0) {
-                    o.bytesOffset += static_cast<size_t>(n);
-                    if (o.bytesOffset == o.bytes.size()) c.out.pop_front();
-                    continue;
-                }
-                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
-                closeConn(id);
-                return;
-            }
-
-            if (o.kind == Outgoing::Kind::FILE_FD) {
-                off_t off = static_cast<off_t>(o.file.offset + o.fileSent);
-                const size_t left = static_cast<size_t>(o.file.length - o.fileSent);
-                if (left == 0) {
-                    c.out.pop_front();
-                    continue;
-                }
-                const ssize_t n = ::sendfile(c.fd.get(), o.file.fd.get(), &off, left);
-                if (n > 0) {
-                    o.fileSent += static_cast<uint64_t>(n);
-                    if (o.fileSent == o.file.length) c.out.pop_front();
-                    continue;
-                }
-                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
-
-                // fallback to copy (read+send) for non-sendfile capable fd
-                char tmp[8192];
-                const ssize_t r = ::pread(o.file.fd.get(), tmp, sizeof(tmp),
-                                          static_cast<off_t>(o.file.offset + o.fileSent));
-                if (r <= 0) {
-                    closeConn(id);
-                    return;
-                }
-                const ssize_t s = ::send(c.fd.get(), tmp, static_cast<size_t>(r), MSG_NOSIGNAL);
-                if (s > 0) {
-                    o.fileSent += static_cast<uint64_t>(s);
-                    if (o.fileSent == o.file.length) c.out.pop_front();
-                    continue;
-                }
+        WriteStatus status = WriteStatus::PROGRESS;
+        while (!c.out.empty() && status == WriteStatus::PROGRESS) {
+            switch (c.out.front().kind) {
+            case Outgoing::Kind::BYTES:
+                status = writeBytes(c);
+                break;
+            case Outgoing::Kind::FILE_FD:
+                status = writeFile(c);
+                break;
+            case Outgoing::Kind::DMABUF:
+                status = writeDmaBuf(c);
+                break;
+            case Outgoing::Kind::STREAM:
+                status = writeStream(c);
                 break;
             }
+        }
+        if (status == WriteStatus::FAILED) {
+            closeConn(id);
+            return;
+        }
+        c.lastActive = now_;
+        schedule(c); // handler 完成或流结束后重新开始空闲计时
+        if (status == WriteStatus::WOULD_BLOCK) {
+            enableWrite(c);
+            return;
+        }
 
-            if (o.kind == Outgoing::Kind::DMABUF) {
-#if UTILSCORE_NET_HAS_DMABUF
-                if (!o.dmabuf.buf) {
-                    c.out.pop_front();
-                    continue;
-                }
-                if (o.dmabufSent >= o.dmabuf.length) {
-                    c.out.pop_front();
-                    continue;
-                }
-                // v1: map + send (copy). Later: add platform-specific fast paths.
-                auto view = o.dmabuf.buf->scopedMap();
-                const uint64_t off = o.dmabuf.offset + o.dmabufSent;
-                const uint64_t left = o.dmabuf.length - o.dmabufSent;
-                const size_t chunk = static_cast<size_t>(std::min<uint64_t>(left, 64 * 1024));
-                const ssize_t n = ::send(c.fd.get(),
-                                         reinterpret_cast<const char*>(view.get() + off),
-                                         chunk,
-                                         MSG_NOSIGNAL);
-                if (n > 0) {
-                    o.dmabufSent += static_cast<uint64_t>(n);
-                    continue;
-                }
-                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
-                closeConn(id);
-                return;
-#else
-                // DMABUF not available in this build environment.
-                closeConn(id);
-                return;
-#endif
-            }
+        // 已全部写出, 或流式响应在等生产端
+        disableWrite(c);
+        if (c.out.empty() && c.closing) closeConn(id);
+    }
+
+    static Clock::time_point after(Clock::time_point from, int sec) {
+        return sec > 0 ? from + std::chrono::seconds(sec) : Clock::time_point::max();
+    }
+
+    // 连接应被关闭的时刻; max() 表示不计时.
+    // 正在等 handler 或流式响应的生产端时不计 header/body 时限 (不是对端造成的停顿),
+    // 但仍按 idleTimeoutSec 兜底: 卡死的 handler / 生产端不会让连接永远挂着
+    Clock::time_point deadlineOf(const Connection& c) const {
+        const ServerConfig& cfg = owner_.cfg_;
+        if (!c.window.empty() || (!c.out.empty() && c.out.front().kind == Outgoing::Kind::STREAM)) {
+            return after(c.lastActive, cfg.idleTimeoutSec);
         }
+        switch (c.phase) {
+        case Connection::Phase::HEADER:
+            return after(c.phaseStart, cfg.requestHeaderTimeoutSec);
+        case Connection::Phase::BODY:
+            return after(c.phaseStart, cfg.requestBodyTimeoutSec);
+        default:
+            return after(c.lastActive, cfg.idleTimeoutSec);
+        }
+    }
 
-        if (c.out.empty()) {
-            disableWrite(c);
-            if (c.closing) {
-                closeConn(id);
-                return;
+    // 只在期限比已登记的条目更早时入堆; 期限推后 (如新的读写) 不动堆, 到期检查时再补登记
+    void schedule(Connection& c) {
+        const Clock::time_point at = deadlineOf(c);
+        if (at >= c.timerAt) return;
+        c.timerAt = at;
+        timers_.push(TimerEntry{at, c.ctx.id});
+    }
+
+    void expireTimers() {
+        while (!timers_.empty() && timers_.top().at <= now_) {
+            const TimerEntry entry = timers_.top();
+            timers_.pop();
+            auto it = conns_.find(entry.connId);
+            if (it == conns_.end() || it->second.timerAt != entry.at) continue;
+
+            Connection& c = it->second;
+            c.timerAt = Clock::time_point::max();
+            if (deadlineOf(c) <= now_) {
+                counters_.timedOut.fetch_add(1, std::memory_order_relaxed);
+                closeConn(entry.connId);
+            } else {
+                schedule(c);
             }
         }
     }
 
-    void reapIdle(const std::chrono::steady_clock::time_point& now) {
-        if (owner_.cfg_.idleTimeoutSec <= 0) return;
-        const auto timeout = std::chrono::seconds(owner_.cfg_.idleTimeoutSec);
-        std::vector<uint64_t> dead;
-        for (const auto& kv : conns_) {
-            if (now - kv.second.lastActive > timeout) dead.push_back(kv.first);
-        }
-        for (auto id : dead) closeConn(id);
+    // epoll_wait 一直睡到最近的期限, 没有期限时只由事件唤醒
+    int pollTimeoutMs() const {
+        if (timers_.empty()) return -1;
+        const auto wait = std::chrono::duration_cast<std::chrono::nanoseconds>(timers_.top().at - Clock::now());
+        if (wait.count() <= 0) return 0;
+        const int64_t ms = (wait.count() + 999999) / 1000000; // 向上取整, 避免提前醒来空转
+        return static_cast<int>(std::min<int64_t>(ms, 24 * 3600 * 1000));
     }
 
     void closeConn(uint64_t id) {
@@ -742,6 +1230,7 @@ private:
         conns_.erase(it);
     }
 
+    Impl& impl_;
     Server& owner_;
 
     std::atomic<bool> running_{false};
@@ -750,14 +1239,91 @@ private:
     FdWrapper epollFd_{-1};
     FdWrapper wakeFd_{-1};
     FdWrapper listenFd_{-1};
+    bool distribute_{false};
 
-    uint64_t nextConnId_{1};
     std::unordered_map<uint64_t, Connection> conns_;
 
     std::mutex outMutex_;
     std::deque<Pending> pending_;
+    std::deque<Adopted> adopted_;
+    std::vector<uint64_t> streamReady_; // 有新数据的流式响应所属连接
+
+    Clock::time_point now_; // 本轮 epoll_wait 返回的时刻
+    std::priority_queue<TimerEntry, std::vector<TimerEntry>, TimerLater> timers_;
+
+    // 仅本 reactor 线程写入, getStats() 可在任意线程读取
+    struct Counters {
+        std::atomic<uint64_t> accepted{0};
+        std::atomic<uint64_t> responses{0};
+        std::atomic<uint64_t> writeCalls{0};
+        std::atomic<uint64_t> pollUpdates{0};
+        std::atomic<uint64_t> timedOut{0};
+    } counters_;
 };
 
+Server::Impl::~Impl() = default;
+
+bool Server::Impl::start() {
+    if (!reactors_.empty()) return false;
+
+    const uint32_t count = std::max<uint32_t>(1, owner_.cfg_.ioThreads);
+    std::vector<std::unique_ptr<Reactor>> reactors;
+    for (uint32_t i = 0; i < count; ++i) {
+        std::unique_ptr<Reactor> r(new Reactor(*this));
+        if (!r->init()) return false;
+        reactors.push_back(std::move(r));
+    }
+
+    if (!openListeners(reactors)) return false;
+
+    reactors_ = std::move(reactors);
+    for (auto& r : reactors_) r->run();
+    return true;
+}
+
+void Server::Impl::stop() {
+    for (auto& r : reactors_) r->stop();
+}
+
+void Server::Impl::join() {
+    for (auto& r : reactors_) r->join();
+}
+
+ServerStats Server::Impl::stats() const {
+    ServerStats out;
+    for (const auto& r : reactors_) r->addStats(out);
+    return out;
+}
+
+bool Server::Impl::openListeners(std::vector<std::unique_ptr<Reactor>>& reactors) {
+    const ServerConfig& cfg = owner_.cfg_;
+    if (reactors.size() > 1 && cfg.reusePort) {
+        std::vector<FdWrapper> fds;
+        uint16_t port = cfg.port;
+        for (size_t i = 0; i < reactors.size(); ++i) {
+            const int fd = openListener(cfg, port, true);
+            if (fd < 0) break;
+            fds.emplace_back(fd);
+            if (port == 0) port = boundPort(fd); // 端口 0: 其余 reactor 绑定到内核分配的同一端口
+        }
+        if (fds.size() == reactors.size()) {
+            for (size_t i = 0; i < reactors.size(); ++i) {
+                if (!reactors[i]->listen(std::move(fds[i]), false)) return false;
+            }
+            return true;
+        }
+    }
+
+    const int fd = openListener(cfg, cfg.port, false);
+    if (fd < 0) return false;
+    return reactors[0]->listen(FdWrapper(fd), reactors.size() > 1);
+}
+
+Server::Impl::Reactor& Server::Impl::nextReactor() {
+    const uint32_t i = nextReactor_.fetch_add(1, std::memory_order_relaxed);
+    return *reactors_[i % reactors_.size()];
+}
+
 Server::Server(ServerConfig cfg)
     : impl_(new Impl(*this))
     , cfg_(std::move(cfg))
@@ -788,5 +1354,9 @@ void Server::join() {
     impl_->join();
 }
 
+ServerStats Server::getStats() const {
+    return impl_->stats();
+}
+
 } // namespace net
 } // namespace utils
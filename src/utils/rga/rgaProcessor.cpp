@@ -129,10 +129,10 @@ std::string RgaProcessorConfig::toString() const {
     char buffer[512];
     snprintf(buffer, sizeof(buffer),
              "RgaProcessorConfig{width=%u, height=%u, srcFormat=%d, dstFormat=%d, "
-             "usingDMABUF=%s, poolSize=%d, maxPendingTasks=%d}",
+             "usingDMABUF=%s, poolSize=%d, maxPendingTasks=%d, workerAffinity=%zu cores}",
              width, height, srcFormat, dstFormat,
              usingDMABUF ? "true" : "false",
-             poolSize, maxPendingTasks);
+             poolSize, maxPendingTasks, workerAffinity.size());
     return std::string(buffer);
 }
 
@@ -157,7 +157,12 @@ RgaProcessor::RgaProcessor(const RgaProcessorConfig& config)
     }
     
     // 创建线程
-    threadPool_ = std::make_unique<asyncThreadPool>(config_.poolSize);
+    // 转换任务在线程池里执行, 只绑定调度线程时工作线程仍会在核间迁移
+    asyncThreadPool::PlacementPolicy placement;
+    placement.cpus = config_.workerAffinity;
+    placement.threadName = "rga";
+    threadPool_ = std::make_unique<asyncThreadPool>(config_.poolSize, -1, 64,
+                                                    asyncThreadPool::ScalingPolicy(), placement);
     if (!config_.rawQueue.lock()) {
         LOG_ERROR("Raw frame queue invalid.\n");
     }
@@ -587,7 +592,8 @@ void RgaProcessor::workerThreadMain() {
             inFlightTasks_.fetch_add(1, std::memory_order_relaxed);
         }
 
-        if (!threadPool_->try_post(this, &RgaProcessor::processOneTask)) {
+        // 每帧转换走 High 通道, 不排在快照等批量任务之后
+        if (!threadPool_->try_post(asyncThreadPool::Priority::High, this, &RgaProcessor::processOneTask)) {
             inFlightTasks_.fetch_sub(1, std::memory_order_relaxed);
             std::lock_guard<std::mutex> lock(taskQueueMutex_);
             taskQueueCv_.notify_one();
@@ -0,0 +1,158 @@
+/*
+ * @FilePath: /src/utils/smallBlockPool.cpp
+ * @Description: 线程池任务节点/promise 状态使用的进程级小块内存池
+ */
+#include "internal/smallBlockPool.h"
+#include "noDestroySingleton.h"
+
+#include <cstdlib>
+#include <mutex>
+
+namespace utils {
+namespace internal {
+
+namespace {
+
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+// 每线程每档位最多缓存的块数, 超出后归还一半到中心链表
+constexpr std::size_t kMaxCachedPerClass = 256;
+// 与中心链表交换时的批量大小
+constexpr std::size_t kTransferBatch = 64;
+
+struct CentralList {
+    std::mutex mtx;
+    FreeBlock* head = nullptr;
+    std::size_t count = 0;
+};
+
+struct CentralLists {
+    CentralList lists[SmallBlockPool::kClassCount];
+};
+
+CentralLists& central() {
+    // 线程退出时 ThreadCache 析构会访问中心链表, 不能依赖静态析构顺序
+    return utils::noDestroySingleton([] { return new CentralLists(); });
+}
+
+inline std::size_t classIndex(std::size_t bytes) {
+    return bytes == 0 ? 0 : (bytes - 1) / SmallBlockPool::kGranularity;
+}
+
+inline std::size_t classBytes(std::size_t index) {
+    return (index + 1) * SmallBlockPool::kGranularity;
+}
+
+// 从缓存链表头部摘下 n 个块, 返回链表头, tail 输出链表尾
+FreeBlock* detachChain(FreeBlock*& head, std::size_t n, FreeBlock*& tail) {
+    FreeBlock* first = head;
+    tail = head;
+    for (std::size_t i = 1; i < n && tail->next; ++i) tail = tail->next;
+    head = tail->next;
+    tail->next = nullptr;
+    return first;
+}
+
+struct ThreadCache {
+    FreeBlock* heads[SmallBlockPool::kClassCount] = {};
+    std::size_t counts[SmallBlockPool::kClassCount] = {};
+
+    ~ThreadCache() {
+        // 线程退出: 全部归还中心链表, 供其他线程复用
+        for (std::size_t i = 0; i < SmallBlockPool::kClassCount; ++i) {
+            if (counts[i] == 0) continue;
+            FreeBlock* tail = nullptr;
+            FreeBlock* chain = detachChain(heads[i], counts[i], tail);
+            CentralList& list = central().lists[i];
+            std::lock_guard<std::mutex> lock(list.mtx);
+            tail->next = list.head;
+            list.head = chain;
+            list.count += counts[i];
+            counts[i] = 0;
+        }
+    }
+};
+
+ThreadCache& threadCache() {
+    static thread_local ThreadCache cache;
+    return cache;
+}
+
+void refill(ThreadCache& cache, std::size_t index) {
+    CentralList& list = central().lists[index];
+    {
+        std::lock_guard<std::mutex> lock(list.mtx);
+        if (list.count > 0) {
+            const std::size_t take = list.count < kTransferBatch ? list.count : kTransferBatch;
+            FreeBlock* tail = nullptr;
+            FreeBlock* chain = detachChain(list.head, take, tail);
+            list.count -= take;
+            tail->next = cache.heads[index];
+            cache.heads[index] = chain;
+            cache.counts[index] += take;
+            return;
+        }
+    }
+
+    // 中心链表也为空: 新申请一整页并切分
+    const std::size_t blockBytes = classBytes(index);
+    void* page = nullptr;
+    if (posix_memalign(&page, SmallBlockPool::kGranularity, blockBytes * kTransferBatch) != 0) {
+        throw std::bad_alloc();
+    }
+    char* base = static_cast<char*>(page);
+    for (std::size_t i = 0; i < kTransferBatch; ++i) {
+        auto* block = reinterpret_cast<FreeBlock*>(base + i * blockBytes);
+        block->next = cache.heads[index];
+        cache.heads[index] = block;
+    }
+    cache.counts[index] += kTransferBatch;
+}
+
+void flushHalf(ThreadCache& cache, std::size_t index) {
+    const std::size_t give = cache.counts[index] / 2;
+    FreeBlock* tail = nullptr;
+    FreeBlock* chain = detachChain(cache.heads[index], give, tail);
+    cache.counts[index] -= give;
+
+    CentralList& list = central().lists[index];
+    std::lock_guard<std::mutex> lock(list.mtx);
+    tail->next = list.head;
+    list.head = chain;
+    list.count += give;
+}
+
+} // namespace
+
+void* SmallBlockPool::allocate(std::size_t bytes) {
+    if (bytes > kMaxBytes) return ::operator new(bytes);
+
+    const std::size_t index = classIndex(bytes);
+    ThreadCache& cache = threadCache();
+    if (cache.counts[index] == 0) refill(cache, index);
+
+    FreeBlock* block = cache.heads[index];
+    cache.heads[index] = block->next;
+    --cache.counts[index];
+    return block;
+}
+
+void SmallBlockPool::deallocate(void* p, std::size_t bytes) noexcept {
+    if (!p) return;
+    if (bytes > kMaxBytes) {
+        ::operator delete(p);
+        return;
+    }
+
+    const std::size_t index = classIndex(bytes);
+    ThreadCache& cache = threadCache();
+    auto* block = static_cast<FreeBlock*>(p);
+    block->next = cache.heads[index];
+    cache.heads[index] = block;
+    if (++cache.counts[index] > kMaxCachedPerClass) flushHalf(cache, index);
+}
+
+} // namespace internal
+} // namespace utils